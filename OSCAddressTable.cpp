@@ -0,0 +1,140 @@
+/*
+ The Center for New Music and Audio Technologies,
+ University of California, Berkeley.  Copyright (c) 2014, The Regents of
+ the University of California (Regents).
+ 
+ Permission to use, copy, modify, distribute, and distribute modified versions
+ of this software and its documentation without fee and without a signed
+ licensing agreement, is hereby granted, provided that the above copyright
+ notice, this paragraph and the following two paragraphs appear in all copies,
+ modifications, and distributions.
+ 
+ IN NO EVENT SHALL REGENTS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS, ARISING
+ OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF REGENTS HAS
+ BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE. THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED
+ HEREUNDER IS PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE
+ MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+#include "OSCAddressTable.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*=============================================================================
+	CONSTRUCTORS / DESTRUCTOR
+=============================================================================*/
+
+OSCAddressTable::OSCAddressTable(int addresses, int characters){
+	//kept at most 3/4 full, so there's always an empty slot to stop a search
+	numSlots = 4;
+	while (numSlots * 3 < addresses * 4){
+		numSlots *= 2;
+	}
+	hashes = (uint32_t *) malloc(numSlots * sizeof(uint32_t));
+	offsets = (int *) malloc(numSlots * sizeof(int));
+	strings = (char *) malloc(characters);
+	if (hashes == NULL || offsets == NULL || strings == NULL){
+		free(hashes);
+		free(offsets);
+		free(strings);
+		hashes = NULL;
+		offsets = NULL;
+		strings = NULL;
+		numSlots = 0;
+		characters = 0;
+	}
+	stringsSize = characters;
+	empty();
+}
+
+OSCAddressTable::~OSCAddressTable(){
+	free(hashes);
+	free(offsets);
+	free(strings);
+}
+
+void OSCAddressTable::empty(){
+	for (int i = 0; i < numSlots; i++){
+		offsets[i] = -1;
+	}
+	count = 0;
+	stringsLength = 0;
+}
+
+/*=============================================================================
+	INTERNING
+=============================================================================*/
+
+uint32_t OSCAddressTable::hash(const char * address){
+	uint32_t h = 2166136261UL;
+	while (*address != '\0'){
+		h ^= (uint8_t) *address++;
+		h *= 16777619UL;
+	}
+	return h;
+}
+
+int OSCAddressTable::slot(const char * address, uint32_t h){
+	int mask = numSlots - 1;
+	int i = h & mask;
+	while (offsets[i] >= 0){
+		if (hashes[i] == h && strcmp(strings + offsets[i], address) == 0){
+			return i;
+		}
+		i = (i + 1) & mask;
+	}
+	return i;
+}
+
+const char * OSCAddressTable::intern(const char * address){
+	return intern(address, hash(address));
+}
+
+const char * OSCAddressTable::intern(const char * address, uint32_t h){
+	if (numSlots == 0){
+		return NULL;
+	}
+	int i = slot(address, h);
+	if (offsets[i] >= 0){
+		return strings + offsets[i];
+	}
+	int length = strlen(address) + 1;
+	if ((count + 1) * 4 > numSlots * 3 || stringsLength + length > stringsSize){
+		return NULL;
+	}
+	memcpy(strings + stringsLength, address, length);
+	hashes[i] = h;
+	offsets[i] = stringsLength;
+	stringsLength += length;
+	count++;
+	return strings + offsets[i];
+}
+
+const char * OSCAddressTable::find(const char * address){
+	return find(address, hash(address));
+}
+
+const char * OSCAddressTable::find(const char * address, uint32_t h){
+	if (numSlots == 0){
+		return NULL;
+	}
+	int i = slot(address, h);
+	return offsets[i] >= 0 ? strings + offsets[i] : NULL;
+}
+
+/*=============================================================================
+	SIZE
+=============================================================================*/
+
+int OSCAddressTable::size(){
+	return count;
+}
+
+int OSCAddressTable::available(){
+	return stringsSize - stringsLength;
+}
@@ -0,0 +1,109 @@
+/*
+ The Center for New Music and Audio Technologies,
+ University of California, Berkeley.  Copyright (c) 2014, The Regents of
+ the University of California (Regents).
+ 
+ Permission to use, copy, modify, distribute, and distribute modified versions
+ of this software and its documentation without fee and without a signed
+ licensing agreement, is hereby granted, provided that the above copyright
+ notice, this paragraph and the following two paragraphs appear in all copies,
+ modifications, and distributions.
+ 
+ IN NO EVENT SHALL REGENTS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS, ARISING
+ OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF REGENTS HAS
+ BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE. THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED
+ HEREUNDER IS PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE
+ MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+#ifndef OSCADDRESSTABLE_h
+#define OSCADDRESSTABLE_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ keeps one copy of each address, found again by its hash
+
+ a message or bundle given a table takes its addresses from it: decoding an
+ address which was seen before costs a hash and a compare instead of an
+ allocation, and every message with that address points to the same copy,
+ so two interned addresses are equal exactly when the pointers are.
+
+ the slots and the characters are allocated once, when the table is made.
+ an address which doesn't fit is left to the message to copy as usual.
+ */
+
+class OSCAddressTable
+{
+
+private:
+
+	//the hash of the address in each slot
+	uint32_t * hashes;
+	//where each slot's address starts in strings, -1 for an empty slot
+	int * offsets;
+	//a power of two
+	int numSlots;
+	//the number of addresses
+	int count;
+
+	char * strings;
+	int stringsLength;
+	int stringsSize;
+
+	//the slot with the address, or the empty one where it would go
+	int slot(const char * address, uint32_t hash);
+
+	//not copyable
+	OSCAddressTable(const OSCAddressTable &);
+	OSCAddressTable & operator=(const OSCAddressTable &);
+
+public:
+
+/*=============================================================================
+	CONSTRUCTORS / DESTRUCTOR
+=============================================================================*/
+
+	//room for about that many addresses and that many characters in all of them
+	OSCAddressTable(int addresses, int characters);
+
+	~OSCAddressTable();
+
+	//forgets all of the addresses
+	//the messages which have one of them have to be emptied first
+	void empty();
+
+/*=============================================================================
+	INTERNING
+=============================================================================*/
+
+	//returns the table's copy of the address, adding it if it isn't there yet
+	//returns NULL if the table is full
+	const char * intern(const char * address);
+	const char * intern(const char * address, uint32_t hash);
+
+	//returns the table's copy of the address, or NULL if it isn't there
+	const char * find(const char * address);
+	const char * find(const char * address, uint32_t hash);
+
+	//the hash the table uses (32 bit FNV-1a)
+	static uint32_t hash(const char * address);
+
+/*=============================================================================
+	SIZE
+=============================================================================*/
+
+	//the number of addresses
+	int size();
+
+	//the number of characters left for new addresses
+	int available();
+};
+
+#endif
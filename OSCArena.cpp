@@ -0,0 +1,116 @@
+/*
+ The Center for New Music and Audio Technologies,
+ University of California, Berkeley.  Copyright (c) 2014, The Regents of
+ the University of California (Regents).
+ 
+ Permission to use, copy, modify, distribute, and distribute modified versions
+ of this software and its documentation without fee and without a signed
+ licensing agreement, is hereby granted, provided that the above copyright
+ notice, this paragraph and the following two paragraphs appear in all copies,
+ modifications, and distributions.
+ 
+ IN NO EVENT SHALL REGENTS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS, ARISING
+ OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF REGENTS HAS
+ BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE. THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED
+ HEREUNDER IS PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE
+ MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+#include "OSCArena.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*=============================================================================
+	CONSTRUCTORS / DESTRUCTOR
+=============================================================================*/
+
+OSCArena::OSCArena(uint8_t * _buffer, size_t _capacity){
+	buffer = _buffer;
+	capacity = _buffer != NULL ? _capacity : 0;
+	owned = false;
+	used = 0;
+	peak = 0;
+	last = NULL;
+}
+
+OSCArena::OSCArena(size_t _capacity){
+	buffer = (uint8_t *) malloc(_capacity);
+	capacity = buffer != NULL ? _capacity : 0;
+	owned = true;
+	used = 0;
+	peak = 0;
+	last = NULL;
+}
+
+OSCArena::~OSCArena(){
+	if (owned){
+		free(buffer);
+	}
+}
+
+/*=============================================================================
+	ALLOCATION
+=============================================================================*/
+
+void * OSCArena::allocate(size_t size){
+	//line the start up with the alignment
+	size_t padding = (OSC_ARENA_ALIGNMENT - ((uintptr_t) (buffer + used) % OSC_ARENA_ALIGNMENT)) % OSC_ARENA_ALIGNMENT;
+	if (size > capacity - used || padding > capacity - used - size){
+		return NULL;
+	}
+	last = buffer + used + padding;
+	used += padding + size;
+	if (used > peak){
+		peak = used;
+	}
+	return last;
+}
+
+void * OSCArena::reallocate(void * ptr, size_t oldSize, size_t newSize){
+	if (ptr == NULL){
+		return allocate(newSize);
+	}
+	if (ptr == last && last + oldSize == buffer + used){
+		//nothing after it, so it can just be extended
+		size_t start = last - buffer;
+		if (newSize > capacity - start){
+			return NULL;
+		}
+		used = start + newSize;
+		if (used > peak){
+			peak = used;
+		}
+		return ptr;
+	}
+	void * mem = allocate(newSize);
+	if (mem != NULL){
+		memcpy(mem, ptr, oldSize < newSize ? oldSize : newSize);
+	}
+	return mem;
+}
+
+void OSCArena::reset(){
+	used = 0;
+	last = NULL;
+}
+
+/*=============================================================================
+	SIZE
+=============================================================================*/
+
+size_t OSCArena::size(){
+	return used;
+}
+
+size_t OSCArena::available(){
+	return capacity - used;
+}
+
+size_t OSCArena::highWaterMark(){
+	return peak;
+}
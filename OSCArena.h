@@ -0,0 +1,103 @@
+/*
+ The Center for New Music and Audio Technologies,
+ University of California, Berkeley.  Copyright (c) 2014, The Regents of
+ the University of California (Regents).
+ 
+ Permission to use, copy, modify, distribute, and distribute modified versions
+ of this software and its documentation without fee and without a signed
+ licensing agreement, is hereby granted, provided that the above copyright
+ notice, this paragraph and the following two paragraphs appear in all copies,
+ modifications, and distributions.
+ 
+ IN NO EVENT SHALL REGENTS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS, ARISING
+ OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF REGENTS HAS
+ BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE. THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED
+ HEREUNDER IS PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE
+ MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+#ifndef OSCARENA_h
+#define OSCARENA_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+//every allocation starts on a multiple of this many bytes
+#ifndef OSC_ARENA_ALIGNMENT
+#if defined(__AVR__)
+#define OSC_ARENA_ALIGNMENT 1
+#else
+#define OSC_ARENA_ALIGNMENT 8
+#endif
+#endif
+
+/*
+ a region of memory handed out front to back and given back all at once
+
+ a bundle or message made with an arena takes everything it decodes from it
+ (the messages, addresses, type tags and data), so a whole packet costs
+ no heap operations and empty() just moves the arena back to the start.
+ */
+
+class OSCArena
+{
+
+private:
+
+	uint8_t * buffer;
+	size_t capacity;
+	//the number of bytes handed out
+	size_t used;
+	//the most bytes that were ever in use at once
+	size_t peak;
+	//the buffer was malloc'ed by the arena
+	bool owned;
+
+	//the last allocation, it's the only one which can grow in place
+	uint8_t * last;
+
+public:
+
+/*=============================================================================
+	CONSTRUCTORS / DESTRUCTOR
+=============================================================================*/
+
+	//hands out the caller's memory
+	OSCArena(uint8_t * buffer, size_t capacity);
+	//allocates the region once up front
+	OSCArena(size_t capacity);
+
+	~OSCArena();
+
+/*=============================================================================
+	ALLOCATION
+=============================================================================*/
+
+	//returns NULL when there isn't enough room left
+	void * allocate(size_t size);
+
+	//grows the last allocation in place, anything else is copied to a new one
+	//the old bytes are only given back by reset
+	void * reallocate(void * ptr, size_t oldSize, size_t newSize);
+
+	//gives everything back
+	void reset();
+
+/*=============================================================================
+	SIZE
+=============================================================================*/
+
+	//the number of bytes in use
+	size_t size();
+	//the number of bytes left
+	size_t available();
+	//the most bytes that were in use since the arena was made
+	size_t highWaterMark();
+};
+
+#endif
@@ -31,87 +31,361 @@
 =============================================================================*/
 
 OSCBundle::OSCBundle(uint64_t _timetag){
+    setupBundle(_timetag);
+}
+
+OSCBundle::OSCBundle(OSCArena & _arena, uint64_t _timetag){
+    setupBundle(_timetag);
+    arena = &_arena;
+}
+
+void OSCBundle::setupBundle(uint64_t _timetag){
     setTimetag(_timetag);
     numMessages = 0;
+    numAllocated = 0;
+    messagesSize = 0;
+    recycling = false;
+    fixedStorage = false;
     error = OSC_OK;
     messages = NULL;
-    incomingBuffer = NULL;
+    arena = NULL;
+    addresses = NULL;
+    lazyDecoding = false;
+    filter = NULL;
+    filterCount = 0;
+    index = NULL;
+    indexSize = 0;
+    indexCount = -1;
     incomingBufferSize = 0;
     decodeState = STANDBY;
 }
 
 OSCBundle::~OSCBundle(){
-    for (int i = 0; i < numMessages; i++){
-        OSCMessage * msg = getOSCMessage(i);
-        delete msg;
+    releaseBundle();
+}
+
+void OSCBundle::releaseBundle(){
+    for (int i = 0; i < numAllocated; i++){
+        deleteMessage(messages[i]);
+    }
+    if (arena == NULL){
+        free(messages);
+    }
+    free(index);
+}
+
+//COPY
+OSCBundle::OSCBundle(const OSCBundle & bundle){
+    setupBundle(bundle.timetag);
+    copyMessages(bundle);
+}
+
+OSCBundle & OSCBundle::operator=(const OSCBundle & bundle){
+    if (this != &bundle){
+        empty();
+        timetag = bundle.timetag;
+        copyMessages(bundle);
     }
-    free(messages);
-    free(incomingBuffer);
+    return *this;
+}
+
+void OSCBundle::copyMessages(const OSCBundle & bundle){
+    if (!reserveMessages(bundle.numMessages)){
+        return;
+    }
+    for (int i = 0; i < bundle.numMessages; i++){
+        OSCMessage * msg = newMessage();
+        if (msg != NULL){
+            msg->copy(bundle.messages[i]);
+        }
+        append(msg);
+    }
+}
+
+#if __cplusplus >= 201103L
+//MOVE
+OSCBundle::OSCBundle(OSCBundle && bundle){
+    setupBundle(bundle.timetag);
+    take(bundle);
+}
+
+OSCBundle & OSCBundle::operator=(OSCBundle && bundle){
+    if (this != &bundle){
+        releaseBundle();
+        setupBundle(bundle.timetag);
+        take(bundle);
+    }
+    return *this;
+}
+#endif
+
+void OSCBundle::take(OSCBundle & bundle){
+    messages = bundle.messages;
+    numMessages = bundle.numMessages;
+    numAllocated = bundle.numAllocated;
+    messagesSize = bundle.messagesSize;
+    recycling = bundle.recycling;
+    fixedStorage = bundle.fixedStorage;
+    timetag = bundle.timetag;
+    error = bundle.error;
+    arena = bundle.arena;
+    addresses = bundle.addresses;
+    lazyDecoding = bundle.lazyDecoding;
+    filter = bundle.filter;
+    filterCount = bundle.filterCount;
+    index = bundle.index;
+    indexSize = bundle.indexSize;
+    indexCount = bundle.indexCount;
+    decodeState = bundle.decodeState;
+    memcpy(incomingBuffer, bundle.incomingBuffer, sizeof(incomingBuffer));
+    incomingBufferSize = bundle.incomingBufferSize;
+    incomingMessageSize = bundle.incomingMessageSize;
+    //leave it empty
+    bundle.setupBundle(bundle.timetag);
 }
 
 //clears all of the OSCMessages inside
 void OSCBundle::empty(){
     error = OSC_OK;
-    for (int i = 0; i < numMessages; i++){
-        OSCMessage * msg = getOSCMessage(i);
-        delete msg;
+    if (recycling && arena == NULL){
+        //keep the messages and their memory for the next ones
+        for (int i = 0; i < numMessages; i++){
+            messages[i]->empty();
+        }
+    } else {
+        for (int i = 0; i < numAllocated; i++){
+            deleteMessage(messages[i]);
+        }
+        if (arena != NULL){
+            //the messages and everything in them go back at once
+            arena->reset();
+        } else {
+            free(messages);
+        }
+        messages = NULL;
+        messagesSize = 0;
+        numAllocated = 0;
     }
-    free(messages);
-    messages = NULL;
     clearIncomingBuffer();
     numMessages = 0;
+    indexCount = -1;
+    decodeState = STANDBY;
 }
 
 /*=============================================================================
- SETTERS
+ MESSAGE STORAGE
  =============================================================================*/
 
-OSCMessage & OSCBundle::add(char * _address){
-	OSCMessage * msg = new OSCMessage(_address);
-    if (!msg->hasError()){
-        //realloc the array to fit the message
-        OSCMessage ** messageMem = (OSCMessage **) realloc(messages, sizeof(OSCMessage *) * (numMessages + 1));
-        if (messageMem != NULL){
-            messages = messageMem;
-            messages[numMessages] = msg;
-            numMessages++;
-        } else {
+void OSCBundle::reserve(int count, int argsPerMessage){
+    //an arena bundle is already emptied in one step
+    if (arena != NULL){
+        reserveMessages(count - numMessages);
+        return;
+    }
+    recycling = true;
+    //the messages which are already there keep their memory from now on
+    for (int i = 0; i < numAllocated; i++){
+        messages[i]->keepStorage = true;
+    }
+    if (!reserveMessages(count - numMessages)){
+        return;
+    }
+    //make the rest up front
+    while (numAllocated < count){
+        OSCMessage * msg = makeMessage();
+        if (msg == NULL){
             error = ALLOCFAILED;
+            return;
+        }
+        msg->reserve(argsPerMessage);
+        messages[numAllocated++] = msg;
+    }
+}
+
+void OSCBundle::reserveFixed(int count, int argsPerMessage, int bytesPerMessage, int addressLength){
+    reserve(count, argsPerMessage);
+    if (arena != NULL || error != OSC_OK){
+        return;
+    }
+    //each one gets all of its room now, the address with its null
+    for (int i = 0; i < numAllocated; i++){
+        OSCMessage * msg = messages[i];
+        if (!msg->reserveTypes(argsPerMessage) || !msg->reserveValues(bytesPerMessage) || !msg->reserveAddress(addressLength + 1)){
+            error = ALLOCFAILED;
+            return;
+        }
+        msg->storageLimited = true;
+    }
+    fixedStorage = true;
+}
+
+OSCMessage * OSCBundle::makeMessage(){
+    OSCMessage * msg;
+    if (arena == NULL){
+        msg = new OSCMessage();
+    } else {
+        void * mem = arena->allocate(sizeof(OSCMessage));
+        if (mem == NULL){
+            return NULL;
         }
+        msg = new (mem) OSCMessage();
+        msg->arena = arena;
     }
-    return *msg;
+    if (msg != NULL){
+        msg->keepStorage = recycling;
+    }
+    return msg;
+}
+
+OSCMessage * OSCBundle::newMessage(){
+    OSCMessage * msg;
+    if (isKept(numMessages)){
+        //it was emptied, so it's like a new one with memory to spare
+        msg = messages[numMessages];
+        msg->error = INVALID_OSC;
+    } else if (fixedStorage){
+        //there's no room for another
+        return NULL;
+    } else {
+        msg = makeMessage();
+    }
+    if (msg != NULL){
+        msg->addresses = addresses;
+        msg->filter = filter;
+        msg->filterCount = filterCount;
+    }
+    return msg;
+}
+
+bool OSCBundle::isKept(int position){
+    return position >= numMessages && position < numAllocated;
 }
 
-OSCMessage & OSCBundle::add(){
-	OSCMessage * msg = new OSCMessage();
-    //realloc the array to fit the message
-    OSCMessage ** messageMem = (OSCMessage **) realloc(messages, sizeof(OSCMessage *) * (numMessages + 1));
-    if (messageMem != NULL){
-        messages = messageMem;
-        messages[numMessages] = msg;
+bool OSCBundle::push(OSCMessage * msg){
+    indexCount = -1;
+    if (isKept(numMessages) && messages[numMessages] == msg){
         numMessages++;
+        return true;
+    }
+    if (!reserveMessages(1)){
+        return false;
+    }
+    messages[numMessages++] = msg;
+    numAllocated++;
+    return true;
+}
+
+void OSCBundle::deleteMessage(OSCMessage * msg){
+    if (arena != NULL){
+        //its memory goes back when the arena is reset
+        msg->~OSCMessage();
     } else {
+        delete msg;
+    }
+}
+
+bool OSCBundle::reserveMessages(int count){
+    if (numMessages + count <= messagesSize){
+        return true;
+    }
+    if (fixedStorage){
+        error = BUFFER_FULL;
+        return false;
+    }
+    //grow geometrically so adding one at a time doesn't realloc every time
+    int newSize = messagesSize * 2 > 4 ? messagesSize * 2 : 4;
+    if (newSize < numMessages + count){
+        newSize = numMessages + count;
+    }
+    OSCMessage ** messageMem;
+    if (arena != NULL){
+        messageMem = (OSCMessage **) arena->reallocate(messages, sizeof(OSCMessage *) * messagesSize, sizeof(OSCMessage *) * newSize);
+    } else {
+        messageMem = (OSCMessage **) realloc(messages, sizeof(OSCMessage *) * newSize);
+    }
+    if (messageMem == NULL){
         error = ALLOCFAILED;
+        return false;
     }
-    return *msg;
+    messages = messageMem;
+    messagesSize = newSize;
+    return true;
 }
 
-OSCMessage & OSCBundle::add(OSCMessage & _msg){
-    OSCMessage * msg = new OSCMessage(_msg);
-    if (!msg->hasError()){
-        //realloc the array to fit the message
-        OSCMessage ** messageMem = (OSCMessage **) realloc(messages, sizeof(OSCMessage *) * (numMessages + 1));
-        if (messageMem != NULL){
-            messages = messageMem;
-            messages[numMessages] = msg;
-            numMessages++;
+//handed out when a message couldn't be added to the bundle
+static OSCMessage placeholder;
+
+OSCMessage & OSCBundle::append(OSCMessage * msg){
+    if (msg != NULL && !msg->hasError() && push(msg)){
+        return *msg;
+    }
+    if (msg != NULL){
+        if (isKept(numMessages) && messages[numMessages] == msg){
+            msg->empty();
         } else {
-            error = ALLOCFAILED;
+            deleteMessage(msg);
         }
     }
-    return *msg;
+    //nothing is allocated in a fixed bundle, so it ran out of room
+    error = fixedStorage ? BUFFER_FULL : ALLOCFAILED;
+    placeholder.empty();
+    placeholder.error = error;
+    return placeholder;
 }
 
+/*=============================================================================
+ SETTERS
+ =============================================================================*/
+
+OSCMessage & OSCBundle::add(char * _address){
+	OSCMessage * msg = newMessage();
+    if (msg != NULL){
+        msg->error = OSC_OK;
+        msg->setAddress(_address);
+    }
+    return append(msg);
+}
+
+OSCMessage * OSCBundle::add(){
+	OSCMessage * msg = newMessage();
+    if (msg == NULL){
+        error = fixedStorage ? BUFFER_FULL : ALLOCFAILED;
+        return NULL;
+    }
+    if (!push(msg)){
+        deleteMessage(msg);
+        return NULL;
+    }
+    return msg;
+}
+
+OSCMessage & OSCBundle::add(OSCMessage & _msg){
+    OSCMessage * msg = newMessage();
+    if (msg != NULL){
+        msg->copy(&_msg);
+    }
+    return append(msg);
+}
+
+#if __cplusplus >= 201103L
+OSCMessage & OSCBundle::add(OSCMessage && _msg){
+    OSCMessage * msg = newMessage();
+    if (msg != NULL && fixedStorage){
+        //a fixed bundle's message keeps its own memory
+        msg->copy(&_msg);
+    } else if (msg != NULL){
+        //it keeps the memory it already has, even in an arena bundle
+        //a kept message gives up its own for it
+        msg->releaseMessage();
+        msg->setupMessage();
+        msg->take(_msg);
+        msg->keepStorage = recycling;
+        msg->addresses = addresses;
+    }
+    return append(msg);
+}
+#endif
+
 /*=============================================================================
     GETTERS
  =============================================================================*/
@@ -133,6 +407,60 @@ OSCMessage * OSCBundle::getOSCMessage(int pos){
 	} 
 }
 
+OSCMessage * OSCBundle::findOSCMessage(const char * address){
+    uint32_t hash = OSCAddressTable::hash(address);
+    if (indexCount != numMessages && !buildIndex()){
+        //no room for the index, so each one is checked
+        for (int i = 0; i < numMessages; i++){
+            OSCMessage * msg = messages[i];
+            if (msg->address != NULL && msg->getAddressHash() == hash && strcmp(msg->address, address) == 0){
+                return msg;
+            }
+        }
+        return NULL;
+    }
+    //the first one in the probe sequence was added first
+    int mask = indexSize - 1;
+    for (int slot = hash & mask; index[slot] != 0; slot = (slot + 1) & mask){
+        OSCMessage * msg = messages[index[slot] - 1];
+        if (msg->getAddressHash() == hash && strcmp(msg->address, address) == 0){
+            return msg;
+        }
+    }
+    return NULL;
+}
+
+bool OSCBundle::buildIndex(){
+    //at most half full
+    int size = 8;
+    while (size < numMessages * 2){
+        size *= 2;
+    }
+    if (size > indexSize){
+        int * indexMem = (int *) realloc(index, sizeof(int) * size);
+        if (indexMem == NULL){
+            return false;
+        }
+        index = indexMem;
+        indexSize = size;
+    }
+    memset(index, 0, sizeof(int) * indexSize);
+    int mask = indexSize - 1;
+    for (int i = 0; i < numMessages; i++){
+        //a message without an address can't be found
+        if (messages[i]->address == NULL){
+            continue;
+        }
+        int slot = messages[i]->getAddressHash() & mask;
+        while (index[slot] != 0){
+            slot = (slot + 1) & mask;
+        }
+        index[slot] = i + 1;
+    }
+    indexCount = numMessages;
+    return true;
+}
+
 /*=============================================================================
     PATTERN MATCHING
  =============================================================================*/
@@ -141,8 +469,7 @@ OSCMessage * OSCBundle::getOSCMessage(int pos){
 bool OSCBundle::dispatch(const char * pattern, void (*callback)(OSCMessage&), int initial_offset){
 	bool called = false;
 	for (int i = 0; i < numMessages; i++){
-        OSCMessage msg = getOSCMessage(i);
-		called |= msg.dispatch(pattern, callback, initial_offset);
+		called |= messages[i]->dispatch(pattern, callback, initial_offset);
 	}
 	return called;
 }
@@ -151,8 +478,23 @@ bool OSCBundle::dispatch(const char * pattern, void (*callback)(OSCMessage&), in
 bool OSCBundle::route(const char * pattern, void (*callback)(OSCMessage&, int), int initial_offset){
 	bool called = false;
 	for (int i = 0; i < numMessages; i++){
-        OSCMessage msg = getOSCMessage(i);
-		called |= msg.route(pattern, callback, initial_offset);
+		called |= messages[i]->route(pattern, callback, initial_offset);
+	}
+	return called;
+}
+
+bool OSCBundle::dispatch(const OSCPattern & pattern, void (*callback)(OSCMessage&), int initial_offset){
+	bool called = false;
+	for (int i = 0; i < numMessages; i++){
+		called |= messages[i]->dispatch(pattern, callback, initial_offset);
+	}
+	return called;
+}
+
+bool OSCBundle::route(const OSCPattern & pattern, void (*callback)(OSCMessage&, int), int initial_offset){
+	bool called = false;
+	for (int i = 0; i < numMessages; i++){
+		called |= messages[i]->route(pattern, callback, initial_offset);
 	}
 	return called;
 }
@@ -166,6 +508,16 @@ int OSCBundle::size(){
 	return numMessages;
 }
 
+int OSCBundle::bytes(){
+    //the header and the timetag
+    int bundleSize = 16;
+    for (int i = 0; i < numMessages; i++){
+        //each message is preceded by its size
+        bundleSize += 4 + messages[i]->bytes();
+    }
+    return bundleSize;
+}
+
 /*=============================================================================
  ERROR HANDLING
  =============================================================================*/
@@ -194,23 +546,39 @@ void OSCBundle::send(Print &p){
     if (hasError()){
         return;
     }
+    uint8_t buffer[OSC_SEND_BUFFER_SIZE];
+    OSCEncoder encoder(p, buffer, OSC_SEND_BUFFER_SIZE);
+    encode(encoder);
+    encoder.flush();
+}
+
+size_t OSCBundle::encode(uint8_t * buffer, size_t capacity){
+    //don't encode a bundle with errors
+    if (hasError()){
+        return 0;
+    }
+    size_t bundleSize = bytes();
+    if (bundleSize <= capacity){
+        OSCEncoder encoder(buffer, capacity);
+        encode(encoder);
+    }
+    return bundleSize;
+}
+
+void OSCBundle::encode(OSCEncoder &encoder){
     //write the bundle header
-    static uint8_t header[] = {'#', 'b', 'u', 'n', 'd', 'l', 'e', 0};
-    p.write(header, 8);
+    static const uint8_t header[] = {'#', 'b', 'u', 'n', 'd', 'l', 'e', 0};
+    encoder.write(header, 8);
     //write the timetag
     uint64_t t64 = BigEndian(timetag);
-    uint8_t * tptr = (uint8_t *) &t64;
-    p.write(tptr, 8);
-    //send the messages
+    encoder.write((uint8_t *) &t64, 8);
+    //write the messages
     for (int i = 0; i < numMessages; i++){
-        OSCMessage * msg = getOSCMessage(i);
-        int msgSize = msg->bytes();
-        //turn the message size into a pointer
-        uint32_t s32 = BigEndian((uint32_t) msgSize);
-        uint8_t * sptr = (uint8_t *) &s32;
-        //write the messsage size
-        p.write(sptr, 4);
-        msg->send(p);
+        OSCMessage * msg = messages[i];
+        //each message is preceded by its size
+        uint32_t s32 = BigEndian((uint32_t) msg->bytes());
+        encoder.write((uint8_t *) &s32, 4);
+        msg->encode(encoder);
     }
 }
 
@@ -223,6 +591,12 @@ void OSCBundle::fill(uint8_t incomingByte){
 }
 
 void OSCBundle::fill(uint8_t * incomingBytes, int length){
+    //only a fill which starts a bundle can hold the whole of it
+    if (decodeState == STANDBY && incomingBufferSize == 0){
+        if (decodePacket(incomingBytes, length)){
+            return;
+        }
+    }
     while (length--){
         decode(*incomingBytes++);
     }
@@ -232,6 +606,52 @@ void OSCBundle::fill(uint8_t * incomingBytes, int length){
     DECODING
  =============================================================================*/
 
+bool OSCBundle::decodePacket(uint8_t * packet, int length){
+    static const uint8_t header[] = {'#', 'b', 'u', 'n', 'd', 'l', 'e', 0};
+    if (length < 16 || (length & 3) != 0 || memcmp(packet, header, 8) != 0){
+        return false;
+    }
+    //the element sizes have to add up to the rest of the packet
+    int count = 0;
+    int offset = 16;
+    while (offset < length){
+        if (length - offset < 4){
+            return false;
+        }
+        uint32_t msgSize;
+        memcpy(&msgSize, packet + offset, 4);
+        msgSize = BigEndian(msgSize);
+        if (msgSize % 4 != 0 || msgSize == 0 || msgSize > (uint32_t) (length - offset - 4)){
+            return false;
+        }
+        offset += 4 + msgSize;
+        count++;
+    }
+    setTimetag(packet + 8);
+    timetag = BigEndian(timetag);
+    //make room for all of the messages at once
+    if (!reserveMessages(count)){
+        return true;
+    }
+    offset = 16;
+    while (offset < length){
+        uint32_t msgSize;
+        memcpy(&msgSize, packet + offset, 4);
+        msgSize = BigEndian(msgSize);
+        OSCMessage * msg = add();
+        if (msg == NULL){
+            return true;
+        }
+        msg->lazyDecoding = lazyDecoding;
+        msg->fill(packet + offset + 4, msgSize);
+        dropFiltered();
+        offset += 4 + msgSize;
+    }
+    //ready for more messages, just like the byte-wise decoder
+    decodeState = MESSAGE_SIZE;
+    return true;
+}
+
 void OSCBundle::decodeTimetag(){
     //parse the incoming buffer as a uint64
     setTimetag(incomingBuffer);
@@ -259,6 +679,10 @@ void OSCBundle::decodeMessage(uint8_t incomingByte){
        OSCMessage * lastMessage = messages[numMessages - 1];
         //put the bytes in there
         lastMessage->fill(incomingByte);
+        if (dropFiltered()){
+            //only the bytes are counted from here on
+            decodeState = MESSAGE_SKIP;
+        }
         //if it's all done
         if (incomingBufferSize == incomingMessageSize){
             //move onto the next message
@@ -272,6 +696,10 @@ void OSCBundle::decodeMessage(uint8_t incomingByte){
 
 //does not validate the incoming OSC for correctness
 void OSCBundle::decode(uint8_t incomingByte){
+    //there's nowhere to put the rest of the bundle
+    if (error == ALLOCFAILED || error == BUFFER_FULL){
+        return;
+    }
     addToIncomingBuffer(incomingByte);
     switch (decodeState){
         case STANDBY:
@@ -314,6 +742,12 @@ void OSCBundle::decode(uint8_t incomingByte){
 		case MESSAGE:
             decodeMessage(incomingByte);
             break;
+        case MESSAGE_SKIP:
+            if (incomingBufferSize == incomingMessageSize){
+                decodeState = MESSAGE_SIZE;
+                clearIncomingBuffer();
+            }
+            break;
     }
 }
 
@@ -323,20 +757,46 @@ void OSCBundle::decode(uint8_t incomingByte){
  =============================================================================*/
 
 void OSCBundle::addToIncomingBuffer(uint8_t incomingByte){
-    //realloc some space for the new byte and stick it on the end
-	incomingBuffer = (uint8_t *) realloc ( incomingBuffer, incomingBufferSize + 1);
-	if (incomingBuffer != NULL){
-		incomingBuffer[incomingBufferSize++] = incomingByte;
-	} else {
-		error = ALLOCFAILED;
-	}
+    //only the start of each field is kept, the messages are decoded as they arrive
+    if (incomingBufferSize < (int) sizeof(incomingBuffer)){
+        incomingBuffer[incomingBufferSize] = incomingByte;
+    }
+    incomingBufferSize++;
 }
 
 void OSCBundle::clearIncomingBuffer(){
     incomingBufferSize = 0;
-    free(incomingBuffer);
-    incomingBuffer = NULL;
 }
 
+void OSCBundle::setAddressTable(OSCAddressTable * table){
+    addresses = table;
+    //the ones which are already there, so a kept message interns as well
+    for (int i = 0; i < numAllocated; i++){
+        messages[i]->addresses = table;
+    }
+}
+
+bool OSCBundle::dropFiltered(){
+    OSCMessage * msg = messages[numMessages - 1];
+    if (msg->error != FILTERED){
+        return false;
+    }
+    msg->empty();
+    numMessages--;
+    indexCount = -1;
+    return true;
+}
 
+void OSCBundle::setFilter(const char * const * patterns, int count){
+    filter = patterns;
+    filterCount = patterns != NULL ? count : 0;
+    //the ones which are already there, so a kept message filters as well
+    for (int i = 0; i < numAllocated; i++){
+        messages[i]->filter = filter;
+        messages[i]->filterCount = filterCount;
+    }
+}
 
+void OSCBundle::setLazyDecoding(bool lazy){
+    lazyDecoding = lazy;
+}
@@ -42,12 +42,67 @@ private:
 
 	//the number of messages in the array
 	int numMessages;
+	//the number of messages made so far
+	//the ones after numMessages were emptied and are kept to be used again
+	int numAllocated;
+	//how many messages there is room for
+	int messagesSize;
+	//empty() keeps the messages and their memory, set by reserve
+	bool recycling;
+	//only the kept messages are used and they're never grown, set by reserveFixed
+	bool fixedStorage;
     
     uint64_t timetag;
     
     //error codes
     OSCErrorCode error;
     
+    //where the messages come from, NULL for the heap
+    OSCArena * arena;
+    
+    //handed to each message so their addresses are interned, NULL to copy them
+    OSCAddressTable * addresses;
+
+    //the messages decoded from a packet leave their arguments in it, see OSCMessage::setLazyDecoding
+    bool lazyDecoding;
+
+    //handed to each message, the ones it turns away are dropped, see OSCMessage::setFilter
+    const char * const * filter;
+    int filterCount;
+    
+    //open addressing index of message positions by address hash, for findOSCMessage
+    //each slot is a position + 1, 0 when it's empty
+    int * index;
+    int indexSize;
+    //the number of messages in the index, -1 when it has to be rebuilt
+    int indexCount;
+    //fills the index with the messages in order
+    bool buildIndex();
+    
+    void setupBundle(uint64_t);
+    
+    //makes a message with no address, from the arena if there is one
+    //returns NULL if there's no room
+    OSCMessage * makeMessage();
+    //the next message to use, a kept one if there is one, otherwise a new one
+    OSCMessage * newMessage();
+    //whether the message at that position is being kept to be used again
+    bool isKept(int position);
+    //puts a message from newMessage at the end of the bundle
+    bool push(OSCMessage *);
+    void deleteMessage(OSCMessage *);
+    //makes room for that many more messages in the array
+    bool reserveMessages(int count);
+    //copies each of the other bundle's messages
+    void copyMessages(const OSCBundle &);
+    //takes over another bundle's messages, leaving it empty
+    void take(OSCBundle &);
+    //deletes the messages
+    void releaseBundle();
+    //adds a message which was just made to the array
+    //if it has an error it's deleted and a placeholder is returned
+    OSCMessage & append(OSCMessage *);
+    
 /*=============================================================================
  DECODING INCOMING BYTES
  =============================================================================*/
@@ -59,10 +114,14 @@ private:
         TIMETAG,
         MESSAGE_SIZE,
         MESSAGE,
+        //the rest of a message the filter turned away
+        MESSAGE_SKIP,
     } decodeState;
     
-    //stores incoming bytes until they can be decoded
-    uint8_t * incomingBuffer;
+    //stores the header, timetag and message sizes until they can be decoded
+    //the messages decode their own bytes
+    uint8_t incomingBuffer[8];
+    //the number of bytes received for the current field
     int incomingBufferSize;
     
     //the size of the incoming message
@@ -78,9 +137,19 @@ private:
     void decodeTimetag();
     void decodeHeader();
     void decodeMessage(uint8_t);
+    //drops the last message if the filter turned it away, it's kept for the next one
+    //returns true if it was dropped
+    bool dropFiltered();
+    //decodes a whole bundle in one pass
+    //returns false if it has to be left to the byte-wise decoder
+    bool decodePacket(uint8_t *, int);
     
     //just a placeholder while filling
-    OSCMessage & add();
+    //returns NULL if there's no room
+    OSCMessage * add();
+
+    //lays out the header, timetag and each sized message in one pass
+    void encode(OSCEncoder &);
 
 
 public:
@@ -91,12 +160,37 @@ public:
 		
     //default timetag of 1
   	OSCBundle(uint64_t = 1);
+    //the messages and everything in them come from the arena
+    //empty() resets the arena, so nothing taken from the bundle can be kept after it
+  	OSCBundle(OSCArena &, uint64_t = 1);
+
+    //copies every message
+    OSCBundle(const OSCBundle &);
+    OSCBundle & operator=(const OSCBundle &);
+#if __cplusplus >= 201103L
+    //takes the messages without copying them
+    OSCBundle(OSCBundle &&);
+    OSCBundle & operator=(OSCBundle &&);
+#endif
 
 	//DESTRUCTOR
 	~OSCBundle();
 
     //clears all of the OSCMessages inside
     void empty();
+
+    //makes room for that many messages with that many arguments each
+    //from then on empty() keeps the messages and their memory,
+    //and the next add() reuses them, so a bundle which is refilled the same way
+    //each time stops allocating after the first
+    void reserve(int messages, int argsPerMessage);
+
+    //like reserve, with room in each message for that many bytes of arguments and an address
+    //that many characters long, but nothing is ever allocated after it: a message which doesn't
+    //fit, or one past the reserved ones, sets BUFFER_FULL. the addresses aren't interned
+    //fill(uint8_t) does a bounded amount of work for each byte, so it can be called from an interrupt
+    //a bundle with an arena takes its memory from the arena instead
+    void reserveFixed(int messages, int argsPerMessage, int bytesPerMessage, int addressLength);
 	
 /*=============================================================================
     SETTERS
@@ -107,6 +201,10 @@ public:
     //add with nothing in it produces an invalid osc message
 	//copies an existing message into the bundle
 	OSCMessage & add(OSCMessage & msg);
+#if __cplusplus >= 201103L
+	//moves the message into the bundle without copying its data
+	OSCMessage & add(OSCMessage && msg);
+#endif
     
     template <typename T>
     void setTimetag(T t){
@@ -127,6 +225,11 @@ public:
 	
 	//get message by position
 	OSCMessage * getOSCMessage(int position);
+
+	//the first message whose address is exactly that string, NULL if there isn't one
+	//no pattern matching, so it's found by hash instead of comparing with each message
+	//the messages shouldn't be given new addresses while it's in use
+	OSCMessage * findOSCMessage(const char * address);
 	
 /*=============================================================================
     MATCHING
@@ -139,12 +242,59 @@ public:
 	//like dispatch, but allows for partial matches
 	//the address match offset is sent as an argument to the callback
 	bool route(const char * pattern, void (*callback)(OSCMessage&, int), int = 0);
+
+	//the same, with a pattern compiled ahead of time
+	bool dispatch(const OSCPattern & pattern, void (*callback)(OSCMessage&), int = 0);
+	bool route(const OSCPattern & pattern, void (*callback)(OSCMessage&, int), int = 0);
+
+#if __cplusplus >= 201103L
+	//the same, with any callable, see OSCMessage::dispatch
+	//the callback is called by reference for each message, so its state carries over
+	template <typename Callback>
+	bool dispatch(const char * pattern, Callback && callback, int initial_offset = 0){
+		bool called = false;
+		for (int i = 0; i < numMessages; i++){
+			called |= messages[i]->dispatch(pattern, callback, initial_offset);
+		}
+		return called;
+	}
+
+	template <typename Callback>
+	bool route(const char * pattern, Callback && callback, int initial_offset = 0){
+		bool called = false;
+		for (int i = 0; i < numMessages; i++){
+			called |= messages[i]->route(pattern, callback, initial_offset);
+		}
+		return called;
+	}
+
+	template <typename Callback>
+	bool dispatch(const OSCPattern & pattern, Callback && callback, int initial_offset = 0){
+		bool called = false;
+		for (int i = 0; i < numMessages; i++){
+			called |= messages[i]->dispatch(pattern, callback, initial_offset);
+		}
+		return called;
+	}
+
+	template <typename Callback>
+	bool route(const OSCPattern & pattern, Callback && callback, int initial_offset = 0){
+		bool called = false;
+		for (int i = 0; i < numMessages; i++){
+			called |= messages[i]->route(pattern, callback, initial_offset);
+		}
+		return called;
+	}
+#endif
 	
 /*=============================================================================
      SIZE
 =============================================================================*/
 	//returns the number of messages in the bundle;
 	int size();
+
+	//computes the number of bytes the encoded bundle occupies
+	int bytes();
     
 /*=============================================================================
     ERROR
@@ -158,15 +308,41 @@ public:
     SENDING
  =============================================================================*/
     
+    //send the bundle with a single write when it fits in OSC_SEND_BUFFER_SIZE
     void send(Print &p);
+
+    //encodes the bundle into the buffer
+    //returns the number of bytes the encoded bundle needs
+    //if that is more than the capacity nothing is written
+    size_t encode(uint8_t * buffer, size_t capacity);
     
 /*=============================================================================
     FILLING
  =============================================================================*/
     
+    //each message is decoded in place, like OSCMessage::fill(uint8_t)
+    //the start of each message can allocate one, unless the bundle was reserved with reserveFixed
     void fill(uint8_t incomingByte);
     
+    //a complete bundle (e.g. a UDP packet) is decoded in a single pass
+    //anything else is passed through the byte-wise decoder
     void fill(uint8_t * incomingBytes, int length);
+    
+    //the messages added or decoded from then on take their addresses from the table
+    //so a repeated address isn't copied, see OSCMessage::setAddressTable
+    void setAddressTable(OSCAddressTable *);
+
+    //a packet passed to fill(uint8_t *, int) only has each message's address and type tags decoded
+    //each message's arguments are copied out of the packet when one of them is read
+    //the packet has to stay put until the messages have been dispatched
+    //see OSCMessage::setLazyDecoding
+    void setLazyDecoding(bool);
+
+    //only the messages whose address matches one of the patterns (or starts with it) are kept
+    //the others are skipped by their size as soon as their address is complete,
+    //without buffering or allocating anything for their arguments
+    //the patterns aren't copied, NULL keeps every message
+    void setFilter(const char * const * patterns, int count);
 };
 
 #endif
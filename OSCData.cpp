@@ -1,5 +1,6 @@
 
 #include "OSCData.h"
+#include <stddef.h>
 
 /*=============================================================================
 	CONSTRUCTORS
@@ -102,26 +103,71 @@ OSCData::OSCData(uint8_t * b, int len){
 }
 
 OSCData::OSCData (OSCData * datum){
+	copy(datum);
+}
+
+OSCData::OSCData (const OSCData & datum){
+	copy(&datum);
+}
+
+OSCData & OSCData::operator=(const OSCData & datum){
+	if (this != &datum){
+		release();
+		copy(&datum);
+	}
+	return *this;
+}
+
+void OSCData::copy(const OSCData * datum){
 	error = OSC_OK;
 	type = datum->type;
 	bytes = datum->bytes;
-	if (type == 'i' || type == 'f' || type == 'd'|| type == 'y'){
-		data = datum->data;
-	} else if (type == 's' || type == 'b'){
+	if ((type == 's' || type == 'b') && bytes > 0){
 		//allocate a new peice of memory
         uint8_t * mem = (uint8_t * ) malloc(bytes);
         if (mem == NULL){
             error = ALLOCFAILED;
+            bytes = 0;
         } else {
             //copy over the blob length
             memcpy(mem, datum->data.b, bytes);
             data.b = mem;
         }
+	} else {
+		data = datum->data;
+	}
+}
+
+#if __cplusplus >= 201103L
+//MOVE
+OSCData::OSCData (OSCData && datum){
+	error = datum.error;
+	type = datum.type;
+	bytes = datum.bytes;
+	data = datum.data;
+	//nothing left to free
+	datum.bytes = 0;
+}
+
+OSCData & OSCData::operator=(OSCData && datum){
+	if (this != &datum){
+		release();
+		error = datum.error;
+		type = datum.type;
+		bytes = datum.bytes;
+		data = datum.data;
+		datum.bytes = 0;
 	}
+	return *this;
 }
+#endif
 
 //DESTRUCTOR
 OSCData::~OSCData(){
+    release();
+}
+
+void OSCData::release(){
     //if there are no bytes, there is nothing to free
     if (bytes>0){
         //if the data is of type 's' or 'b', need to free that memory
@@ -198,4 +244,279 @@ int OSCData::getBlob(uint8_t * blobBuffer, int length){
     } else {
         return NULL;
     }
-}
\ No newline at end of file
+}
+
+/*=============================================================================
+    ENCODED SIZE
+=============================================================================*/
+
+int oscArgumentSize(char type, const uint8_t * arg, int remaining){
+    int argSize;
+    switch (type){
+        case 'i':
+        case 'f':
+        case 'c':
+        case 'r':
+        case 'm':
+            argSize = 4;
+            break;
+        case 'd':
+        case 't':
+        case 'h':
+            argSize = 8;
+            break;
+        case 'T':
+        case 'F':
+        case 'N':
+        case 'I':
+            argSize = 0;
+            break;
+        case 's':
+        case 'S':{
+            const uint8_t * end = (const uint8_t *) memchr(arg, 0, remaining);
+            if (end == NULL){
+                return -1;
+            }
+            int strSize = end - arg + 1;
+            argSize = strSize + padSize(strSize);
+            }
+            break;
+        case 'b':{
+            if (remaining < 4){
+                return -1;
+            }
+            union {
+                uint32_t i;
+                uint8_t b[4];
+            } u;
+            memcpy(u.b, arg, 4);
+            uint32_t blobLength = BigEndian(u.i);
+            if (blobLength > (uint32_t) remaining){
+                return -1;
+            }
+            argSize = 4 + blobLength + padSize(blobLength);
+            }
+            break;
+        default:
+            return -1;
+    }
+    if (argSize > remaining){
+        return -1;
+    }
+    return argSize;
+}
+
+/*=============================================================================
+    BYTE ORDER
+=============================================================================*/
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+void oscBigEndianCopy32(void * dst, const void * src, int count){
+    uint8_t * d = (uint8_t *) dst;
+    const uint8_t * s = (const uint8_t *) src;
+    const int one = 1;
+    if (*(char *) &one == 0){
+        //big endian machines already have them in order
+        if (d != s){
+            memcpy(d, s, count * 4);
+        }
+        return;
+    }
+    int i = 0;
+#if defined(__SSE2__)
+    //four words at a time: swap the bytes of each 16-bit half, then swap the halves
+    for (; i + 4 <= count; i += 4){
+        __m128i v = _mm_loadu_si128((const __m128i *) (s + i * 4));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+        v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+        _mm_storeu_si128((__m128i *) (d + i * 4), v);
+    }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    //four words at a time
+    for (; i + 4 <= count; i += 4){
+        vst1q_u8(d + i * 4, vrev32q_u8(vld1q_u8(s + i * 4)));
+    }
+#endif
+    //the rest a word at a time
+    for (; i < count; i++){
+#if defined(__AVR__)
+        //8-bit machines are quickest moving the bytes one by one
+        uint8_t b0 = s[i * 4], b1 = s[i * 4 + 1], b2 = s[i * 4 + 2], b3 = s[i * 4 + 3];
+        d[i * 4] = b3;
+        d[i * 4 + 1] = b2;
+        d[i * 4 + 2] = b1;
+        d[i * 4 + 3] = b0;
+#else
+        //compilers turn this into a single byte-reverse instruction
+        uint32_t w;
+        memcpy(&w, s + i * 4, 4);
+        w = (w >> 24) | ((w >> 8) & 0xff00) | ((w << 8) & 0xff0000) | (w << 24);
+        memcpy(d + i * 4, &w, 4);
+#endif
+    }
+}
+
+/*=============================================================================
+    DECODING INTO A STRUCT
+=============================================================================*/
+
+//where the compiler puts a field of that type, so the layout matches the user's struct
+template <typename T> struct OSCFieldAlign {
+    char c;
+    T field;
+};
+#define FIELD_ALIGN(T) ((int) offsetof(OSCFieldAlign<T>, field))
+
+//the 4-byte arguments
+static inline bool isWord(char type){
+    return type == 'i' || type == 'f' || type == 'c' || type == 'r' || type == 'm';
+}
+
+//the size and alignment of the field a type tag is decoded into
+//returns false if there isn't one for that type
+static bool structField(char type, int * size, int * align){
+    switch (type){
+        case 'i':
+        case 'c':
+        case 'r':
+        case 'm':
+            *size = sizeof(int32_t);
+            *align = FIELD_ALIGN(int32_t);
+            return true;
+        case 'f':
+            *size = sizeof(float);
+            *align = FIELD_ALIGN(float);
+            return true;
+        case 'h':
+            *size = sizeof(int64_t);
+            *align = FIELD_ALIGN(int64_t);
+            return true;
+        case 't':
+            *size = sizeof(uint64_t);
+            *align = FIELD_ALIGN(uint64_t);
+            return true;
+        case 'd':
+            //some 8-bit boards only have a 4-byte double
+            if (sizeof(double) != 8){
+                return false;
+            }
+            *size = sizeof(double);
+            *align = FIELD_ALIGN(double);
+            return true;
+        case 's':
+        case 'S':
+            *size = sizeof(const char *);
+            *align = FIELD_ALIGN(const char *);
+            return true;
+        case 'T':
+        case 'F':
+        case 'N':
+        case 'I':
+            *size = 0;
+            *align = 1;
+            return true;
+        default:
+            return false;
+    }
+}
+
+static inline int alignTo(int offset, int align){
+    return (offset + align - 1) / align * align;
+}
+
+int oscStructSize(const char * types){
+    int offset = 0;
+    int largest = 1;
+    for (; *types != '\0'; types++){
+        int size, align;
+        if (!structField(*types, &size, &align)){
+            return -1;
+        }
+        offset = alignTo(offset, align) + size;
+        if (align > largest){
+            largest = align;
+        }
+    }
+    //the struct is padded so an array of them stays aligned
+    return alignTo(offset, largest);
+}
+
+int oscStructAlignment(const char * types){
+    int largest = 1;
+    for (; *types != '\0'; types++){
+        int size, align;
+        if (!structField(*types, &size, &align)){
+            return -1;
+        }
+        if (align > largest){
+            largest = align;
+        }
+    }
+    return largest;
+}
+
+bool oscDecodeStruct(const char * types, const uint8_t * args, int remaining, void * target){
+    uint8_t * fields = (uint8_t *) target;
+    int offset = 0;
+    while (*types != '\0'){
+        int size, align;
+        if (!structField(*types, &size, &align)){
+            return false;
+        }
+        offset = alignTo(offset, align);
+        if (isWord(*types)){
+            //a run of 4-byte arguments goes into fields which follow each other
+            //without padding, so they're swapped in one go
+            int count = 1;
+            while (isWord(types[count])){
+                count++;
+            }
+            if (count * 4 > remaining){
+                return false;
+            }
+            oscBigEndianCopy32(fields + offset, args, count);
+            args += count * 4;
+            remaining -= count * 4;
+            offset += count * 4;
+            types += count;
+            continue;
+        }
+        switch (*types){
+            case 'h':
+            case 't':
+            case 'd':{
+                if (remaining < 8){
+                    return false;
+                }
+                uint64_t value;
+                memcpy(&value, args, 8);
+                value = BigEndian(value);
+                memcpy(fields + offset, &value, 8);
+                args += 8;
+                remaining -= 8;
+                }
+                break;
+            case 's':
+            case 'S':{
+                int argSize = oscArgumentSize(*types, args, remaining);
+                if (argSize < 0){
+                    return false;
+                }
+                const char * str = (const char *) args;
+                memcpy(fields + offset, &str, sizeof(str));
+                args += argSize;
+                remaining -= argSize;
+                }
+                break;
+        }
+        offset += size;
+        types++;
+    }
+    return true;
+}
@@ -50,7 +50,9 @@
 
 //ERRORS/////////////////////////////////////////////////
 typedef enum { OSC_OK = 0,
-	BUFFER_FULL, INVALID_OSC, ALLOCFAILED, INDEX_OUT_OF_BOUNDS
+	BUFFER_FULL, INVALID_OSC, ALLOCFAILED, INDEX_OUT_OF_BOUNDS,
+	//the decoder's filter turned the message's address away
+	FILTERED
 } OSCErrorCode;
 
 class OSCData 
@@ -64,6 +66,11 @@ private:
     //should only be used while decoding
     //leaves an invalid OSCMessage with a type, but no data
     OSCData(char t);
+
+    //copies the type and the data, allocating new memory for strings and blobs
+    void copy(const OSCData *);
+    //frees the string or blob
+    void release();
        
 public:
 
@@ -95,6 +102,13 @@ public:
 	OSCData (uint8_t *, int);
     //accepts another OSCData objects and clones it
 	OSCData (OSCData *);
+	OSCData (const OSCData &);
+	OSCData & operator=(const OSCData &);
+#if __cplusplus >= 201103L
+	//takes the string or blob without copying it
+	OSCData (OSCData &&);
+	OSCData & operator=(OSCData &&);
+#endif
     OSCData  (bool);
     OSCData  (uint64_t);
 
@@ -139,4 +153,29 @@ static inline T BigEndian(const T& x)
     return ret;
 }
 
+//copies 'count' 32-bit words between big endian and the machine's byte order
+//the source and destination can be the same but can't otherwise overlap
+void oscBigEndianCopy32(void * dst, const void * src, int count);
+
+//returns the number of bytes to pad to make it 4-byte aligned
+static inline int padSize(int bytes) { return (4 - (bytes & 3)) & 3; }
+
+//returns the number of bytes (with padding) an encoded argument of that type occupies
+//or -1 if it is not a known type or it runs past the remaining bytes
+int oscArgumentSize(char type, const uint8_t * arg, int remaining);
+
+//arguments can be decoded straight into a struct with one field for each type tag, in order:
+//int32_t for 'i' 'c' 'r' 'm', float for 'f', int64_t for 'h', uint64_t for 't', double for 'd'
+//and const char * for 's' 'S' (pointing at the string where it was decoded from)
+//'T' 'F' 'N' 'I' have no field, the type tag already says what they are
+
+//returns the size of the struct for the type tags, or -1 if one of them can't be decoded into a field
+int oscStructSize(const char * types);
+//the alignment of that struct (its strictest field), or -1 like oscStructSize
+int oscStructAlignment(const char * types);
+
+//fills in the struct's fields from the encoded arguments
+//returns false if they run past the remaining bytes
+bool oscDecodeStruct(const char * types, const uint8_t * args, int remaining, void * target);
+
 #endif
\ No newline at end of file
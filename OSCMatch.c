@@ -25,7 +25,6 @@
 #include "OSCMatch.h"
 
 static int osc_match_star(const char *pattern, const char *address);
-static int osc_match_star_r(const char *pattern, const char *address);
 static int osc_match_single_char(const char *pattern, const char *address);
 static int osc_match_bracket(const char *pattern, const char *address);
 static int osc_match_curly_brace(const char *pattern, const char *address);
@@ -71,16 +70,20 @@ int osc_match(const char *pattern, const char *address, int *pattern_offset, int
 				return 0;
 			}
 			if(*pattern == '['){
-				while(*pattern != ']'){
+				while(*pattern != ']' && *pattern != '\0'){
+					pattern++;
+				}
+				if(*pattern == ']'){
 					pattern++;
 				}
-				pattern++;
 				address++;
 			}else if(*pattern == '{'){
-				while(*pattern != '}'){
+				while(*pattern != '}' && *pattern != '\0'){
+					pattern++;
+				}
+				if(*pattern == '}'){
 					pattern++;
 				}
-				pattern++;
 				address += n;
 			}else{
 				pattern++;
@@ -105,146 +108,89 @@ int osc_match(const char *pattern, const char *address, int *pattern_offset, int
 	return r;
 }
 
+/*
+ matches the rest of a segment which has a star in it, without recursion.
+ the stars are matched lazily: when something after the last star doesn't
+ match, that star takes one more character and the match picks up from
+ just after it. so the time is bounded by the length of the address segment
+ times the length of the pattern segment, whatever the number of stars.
+ */
 static int osc_match_star(const char *pattern, const char *address)
 {
-	const char *address_start = address;
-	const char *pattern_start = pattern;
+	const char *star_pattern = NULL;
+	const char *star_address = NULL;
 	int num_stars = 0;
-	if(*address == '\0') { return 0; }
-	while(*address != '/' && *address != '\0'){
-		address++;
-	}
-	while(*pattern != '/' && *pattern != '\0'){
-		if(*pattern == '*'){
+	const char *p;
+	for(p = pattern; *p != '/' && *p != '\0'; p++){
+		if(*p == '*'){
 			num_stars++;
 		}
-		pattern++;
 	}
-	pattern--;
-	address--;
-	switch(num_stars){
-		case 1:
-		{
-			const char *pp = pattern, *aa = address;
-			while(*pp != '*'){
-				if(!(osc_match_single_char(pp, aa))){
-					return 0;
-				}
-				if(*pp == ']' || *pp == '}'){
-					while(*pp != '[' && *pp != '{'){
-						pp--;
-					}
-				}
-				pp--;
-				aa--;
+#if (OSC_MATCH_ENABLE_2STARS != 1)
+	if(num_stars == 2){ return 0; }
+#endif
+#if (OSC_MATCH_ENABLE_NSTARS != 1)
+	if(num_stars > 2){ return 0; }
+#endif
+	if(*address == '\0') { return 0; }
+	while(*address != '/' && *address != '\0'){
+		if(*pattern == '*'){
+			while(*pattern == '*'){
+				pattern++;
 			}
+			star_pattern = pattern;
+			star_address = address;
+			continue;
 		}
-			break;
-		case 2:
-#if (OSC_MATCH_ENABLE_2STARS == 1)
-		{
-			const char *pp = pattern, *aa = address;
-			while(*pp != '*'){
-				if(!(osc_match_single_char(pp, aa))){
-					return 0;
+		int n = 0;
+		if(*pattern != '/' && *pattern != '\0'){
+			n = osc_match_single_char(pattern, address);
+		}
+		if(n){
+			if(*pattern == '['){
+				while(*pattern != ']' && *pattern != '\0'){
+					pattern++;
 				}
-				if(*pp == ']' || *pp == '}'){
-					while(*pp != '[' && *pp != '{'){
-						pp--;
-					}
+				if(*pattern == ']'){
+					pattern++;
 				}
-				pp--;
-				aa--;
-			}
-			aa++; // we want to start one character forward to allow the star to match nothing
-			const char *star2 = pp;
-			const char *test = aa;
-			int i = 0;
-			while(test > address_start){
-				pp = star2 - 1;
-				aa = test - 1;
-				i++;
-				while(*pp != '*'){
-					if(!osc_match_single_char(pp, aa)){
-						break;
-					}
-					if(*pp == ']' || *pp == '}'){
-						while(*pp != '[' && *pp != '{'){
-							pp--;
-						}
-					}
-					pp--;
-					aa--;
+				address++;
+			}else if(*pattern == '{'){
+				while(*pattern != '}' && *pattern != '\0'){
+					pattern++;
 				}
-				if(pp == pattern_start){
-					return 1;
+				if(*pattern == '}'){
+					pattern++;
 				}
-				test--;
+				address += n;
+			}else{
+				pattern++;
+				address++;
 			}
-			return 0;
-		}
-			break;
-#else
-			return 0;
-#endif
-		default:
-#if (OSC_MATCH_ENABLE_NSTARS == 1)
-			return osc_match_star_r(pattern_start, address_start);
-			break;
-#else
-			return 0;
-#endif
-	}
-	return 1;
-}
-
-#if (OSC_MATCH_ENABLE_NSTARS == 1)
-static int osc_match_star_r(const char *pattern, const char *address)
-{
-	if(*address == '/' || *address == '\0'){
-		if(*pattern == '/' || *pattern == '\0' || (*pattern == '*' && ((*(pattern + 1) == '/') || *(pattern + 1) == '\0'))){
-			return 1;
+		}else if(star_pattern != NULL){
+			pattern = star_pattern;
+			address = ++star_address;
 		}else{
 			return 0;
 		}
 	}
-	if(*pattern == '*'){
-		if(osc_match_star_r(pattern + 1, address)){
-			return 1;
-		}else{
-			return osc_match_star_r(pattern, address + 1);
-		}
-	}else{
-		if(!osc_match_single_char(pattern, address)){
-			return 0;
-		}
-		if(*pattern == '[' || *pattern == '{'){
-			while(*pattern != ']' && *pattern != '}'){
-				pattern++;
-			}
-		}
-		return osc_match_star_r(pattern + 1, address + 1);
+	while(*pattern == '*'){
+		pattern++;
 	}
+	return *pattern == '/' || *pattern == '\0';
 }
-#endif
 
 static int osc_match_single_char(const char *pattern, const char *address)
 {
+	// only a '/' matches a '/'
+	if(*address == '/' && *pattern != '/'){
+		return 0;
+	}
 	switch(*pattern){
 		case '[':
 			return osc_match_bracket(pattern, address);
-		case ']':
-			while(*pattern != '['){
-				pattern--;
-			}
-			return osc_match_bracket(pattern, address);
 		case '{':
 			return osc_match_curly_brace(pattern, address);
-		case '}':
-			while(*pattern != '{'){
-				pattern--;
-			}
-			return osc_match_curly_brace(pattern, address);
 		case '?':
 			return 1;
 		default:
@@ -267,8 +213,9 @@ static int osc_match_bracket(const char *pattern, const char *address)
 	}
 	int matched = !val;
 	while(*pattern != ']' && *pattern != '\0'){
-		// the character we're on now is the beginning of a range
-		if(*(pattern + 1) == '-'){
+		// the character we're on now is the beginning of a range, unless
+		// the '-' is the last thing before the ']' or the end of the string
+		if(*(pattern + 1) == '-' && *(pattern + 2) != ']' && *(pattern + 2) != '\0'){
 			if(*address >= *pattern && *address <= *(pattern + 2)){
 				matched = val;
 				break;
@@ -298,10 +245,13 @@ static int osc_match_curly_brace(const char *pattern, const char *address)
 		int n = ptr - pattern;
 		if(!strncmp(pattern, address, n)){
 			return n;
-		}else{
-			ptr++;
-			pattern = ptr;
 		}
+		if(*ptr != ','){
+			// '}', '/' or the end of an unclosed brace: no more alternatives
+			return 0;
+		}
+		ptr++;
+		pattern = ptr;
 	}
 	return 0;
 }
\ No newline at end of file
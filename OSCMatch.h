@@ -32,8 +32,7 @@ extern "C" {
 	 */
     //#define OSC_MATCH_ENABLE_2STARS		1
 	/**
-	 * Switch this off to disable matching against a pattern with more than 2 stars which will
-	 * be done recursively.
+	 * Switch this off to disable matching against a pattern with more than 2 stars.
 	 */
     //#define OSC_MATCH_ENABLE_NSTARS		1
 	
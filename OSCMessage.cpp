@@ -24,7 +24,9 @@
  */
 
 #include "OSCMessage.h"
+#include "OSCMessageView.h"
 #include "OSCMatch.h"
+#include <limits.h>
 
 /*=============================================================================
 	CONSTRUCTORS / DESTRUCTOR
@@ -56,145 +58,871 @@ void OSCMessage::setupMessage(){
 	address = NULL;
 	//setup the attributes
 	dataCount = 0;
+	borrowedCount = 0;
+	borrowedExtra = 0;
 	error = OSC_OK;
-	//setup the space for data
-	data = NULL;
+	//the data is allocated as it's added
+	types = NULL;
+	typesSize = 0;
+	values = NULL;
+	valuesLength = 0;
+	valuesSize = 0;
+	cursorPosition = 0;
+	cursorOffset = 0;
+	datumCopy = NULL;
+	arena = NULL;
+	arenaOwner = false;
+	keepStorage = false;
+	storageFixed = false;
+	storageLimited = false;
+	addressSize = 0;
+	addresses = NULL;
+	addressInterned = false;
+	addressHash = 0;
+	addressHashed = false;
+	lazyDecoding = false;
+	lazyTypes = NULL;
+	lazyArguments = NULL;
+	lazyCount = 0;
+	lazyLength = 0;
+	filter = NULL;
+	filterCount = 0;
     //setup for filling the message
-    incomingBuffer = NULL;
-    incomingBufferSize = 0;
-    incomingBufferFree = 0;
-    clearIncomingBuffer();
+    decodeLength = 0;
+    decodeSize = 0;
+    decodeCount = 0;
     //set the decode state
     decodeState = STANDBY;
 }
 
+//constructor with an arena
+//it has no address until one is decoded
+OSCMessage::OSCMessage(OSCArena & _arena){
+    setupMessage();
+    arena = &_arena;
+    arenaOwner = true;
+    error = INVALID_OSC;
+}
+
+void OSCMessage::useStorage(char * addressBuffer, int addressCapacity, char * typesBuffer, int typesCapacity, uint8_t * valuesBuffer, int valuesCapacity){
+    releaseAddress();
+    release(types);
+    release(values);
+    storageFixed = true;
+    address = addressBuffer;
+    addressSize = addressCapacity;
+    address[0] = '\0';
+    addressHashed = false;
+    types = typesBuffer;
+    typesSize = typesCapacity;
+    values = valuesBuffer;
+    valuesSize = valuesCapacity;
+    dataCount = 0;
+    valuesLength = 0;
+    borrowedCount = 0;
+    borrowedExtra = 0;
+    cursorPosition = 0;
+    cursorOffset = 0;
+    lazyTypes = NULL;
+    lazyCount = 0;
+}
+
 //DESTRUCTOR
 OSCMessage::~OSCMessage(){
+    releaseMessage();
+}
+
+void OSCMessage::releaseMessage(){
 	//free everything that needs to be freed
+    keepStorage = false;
     //free the address
-	free(address);
+	releaseAddress();
     //free the data
     empty();
-    //free the filling buffer
-    free(incomingBuffer);
 }
 
 void OSCMessage::empty(){
     error = OSC_OK;
-    //free each of hte data in the array
-    for (int i = 0; i < dataCount; i++){
-        OSCData * datum = getOSCData(i);
-        //explicitly destruct the data
-        //datum->~OSCData();
-        delete datum;
-    }
-    //and free the array
-    free(data);
-    data = NULL;
+    //free the type tags and the data
+    if (!storageFixed && !keepStorage){
+        release(types);
+        types = NULL;
+        typesSize = 0;
+        release(values);
+        values = NULL;
+        valuesSize = 0;
+    }
+    valuesLength = 0;
     dataCount = 0;
-    clearIncomingBuffer();
+    borrowedCount = 0;
+    borrowedExtra = 0;
+    cursorPosition = 0;
+    cursorOffset = 0;
+    lazyTypes = NULL;
+    lazyCount = 0;
+    delete datumCopy;
+    datumCopy = NULL;
+    decodeState = STANDBY;
+    decodeLength = 0;
+    decodeSize = 0;
+    decodeCount = 0;
+    if (arenaOwner){
+        //everything the message had goes back at once
+        arena->reset();
+        address = NULL;
+        addressSize = 0;
+        addressInterned = false;
+        addressHashed = false;
+        types = NULL;
+        typesSize = 0;
+        values = NULL;
+        valuesSize = 0;
+        error = INVALID_OSC;
+    }
 }
 
 //COPY
 OSCMessage::OSCMessage(OSCMessage * msg){
+    setupMessage();
+    copy(msg);
+}
+
+//deep copy
+OSCMessage::OSCMessage(const OSCMessage & msg){
+    setupMessage();
+    copy(&msg);
+}
+
+OSCMessage & OSCMessage::operator=(const OSCMessage & msg){
+    if (this != &msg){
+        empty();
+        copy(&msg);
+    }
+    return *this;
+}
+
+void OSCMessage::copy(const OSCMessage * msg){
+    if (msg->address == NULL){
+        //there's nothing to copy
+        error = INVALID_OSC;
+        return;
+    }
+    error = OSC_OK;
 	//start with a message with the same address
+    if (msg->addressInterned && !storageFixed && !storageLimited){
+        //the same table's copy
+        releaseAddress();
+        address = msg->address;
+        addressSize = 0;
+        addressInterned = true;
+        addressHash = msg->addressHash;
+        addressHashed = msg->addressHashed;
+    } else {
+        setAddress(msg->address);
+    }
+	//copy the type tags and the data in one go
+    //borrowed data stays borrowed
+    if (reserveTypes(msg->dataCount) && reserveValues(msg->valuesLength)){
+        if (msg->dataCount > 0){
+            memcpy(types, msg->types, msg->dataCount);
+        }
+        if (msg->valuesLength > 0){
+            memcpy(values, msg->values, msg->valuesLength);
+        }
+        dataCount = msg->dataCount;
+        valuesLength = msg->valuesLength;
+        borrowedCount = msg->borrowedCount;
+        borrowedExtra = msg->borrowedExtra;
+    }
+    //arguments still in the packet stay there, the copy reads them from the same place
+    lazyTypes = msg->lazyTypes;
+    lazyArguments = msg->lazyArguments;
+    lazyCount = msg->lazyCount;
+    lazyLength = msg->lazyLength;
+}
+
+#if __cplusplus >= 201103L
+//MOVE
+OSCMessage::OSCMessage(OSCMessage && msg){
     setupMessage();
-    setAddress(msg->address);
-	//add each of the data to the other message
-	for (int i = 0; i < msg->dataCount; i++){
-        add(msg->data[i]);
-	}
+    take(msg);
+}
+
+OSCMessage & OSCMessage::operator=(OSCMessage && msg){
+    if (this != &msg){
+        if (storageFixed || storageLimited){
+            //a StaticOSCMessage keeps its own storage, and so does a fixed bundle's message
+            empty();
+            copy(&msg);
+        } else {
+            releaseMessage();
+            setupMessage();
+            take(msg);
+        }
+    }
+    return *this;
+}
+#endif
+
+void OSCMessage::take(OSCMessage & msg){
+    if (msg.storageFixed || msg.storageLimited){
+        copy(&msg);
+        return;
+    }
+    address = msg.address;
+    types = msg.types;
+    typesSize = msg.typesSize;
+    values = msg.values;
+    valuesLength = msg.valuesLength;
+    valuesSize = msg.valuesSize;
+    dataCount = msg.dataCount;
+    borrowedCount = msg.borrowedCount;
+    borrowedExtra = msg.borrowedExtra;
+    error = msg.error;
+    cursorPosition = msg.cursorPosition;
+    cursorOffset = msg.cursorOffset;
+    datumCopy = msg.datumCopy;
+    arena = msg.arena;
+    arenaOwner = msg.arenaOwner;
+    decodeState = msg.decodeState;
+    decodeLength = msg.decodeLength;
+    decodeSize = msg.decodeSize;
+    decodeCount = msg.decodeCount;
+    keepStorage = msg.keepStorage;
+    addressSize = msg.addressSize;
+    addresses = msg.addresses;
+    addressInterned = msg.addressInterned;
+    addressHash = msg.addressHash;
+    addressHashed = msg.addressHashed;
+    lazyDecoding = msg.lazyDecoding;
+    lazyTypes = msg.lazyTypes;
+    lazyArguments = msg.lazyArguments;
+    lazyCount = msg.lazyCount;
+    lazyLength = msg.lazyLength;
+    filter = msg.filter;
+    filterCount = msg.filterCount;
+    //leave it like a message made with OSCMessage()
+    msg.setupMessage();
+    msg.error = INVALID_OSC;
+}
+
+/*=============================================================================
+	DATA STORAGE
+=============================================================================*/
+
+void OSCMessage::reserve(int count, int bytes){
+    if (bytes < 0){
+        bytes = count * 4;
+    }
+    reserveTypes(count);
+    reserveValues(bytes);
+    keepStorage = true;
+}
+
+void * OSCMessage::allocate(void * ptr, int oldSize, int newSize){
+    if (arena != NULL){
+        return arena->reallocate(ptr, oldSize, newSize);
+    }
+    return realloc(ptr, newSize);
+}
+
+void OSCMessage::release(void * ptr){
+    //arena memory is only given back when the arena is reset
+    if (arena == NULL && !storageFixed){
+        free(ptr);
+    }
+}
+
+bool OSCMessage::reserveTypes(int count){
+    if (count <= typesSize){
+        return true;
+    }
+    if (storageFixed || storageLimited){
+        error = BUFFER_FULL;
+        return false;
+    }
+    //grow geometrically so adding one at a time doesn't realloc every time
+    int newSize = typesSize * 2 > 8 ? typesSize * 2 : 8;
+    if (newSize < count){
+        newSize = count;
+    }
+    char * typesMem = (char *) allocate(types, typesSize, newSize);
+    if (typesMem == NULL){
+        error = ALLOCFAILED;
+        return false;
+    }
+    types = typesMem;
+    typesSize = newSize;
+    return true;
+}
+
+bool OSCMessage::reserveValues(int length){
+    if (length <= valuesSize){
+        return true;
+    }
+    if (storageFixed || storageLimited){
+        error = BUFFER_FULL;
+        return false;
+    }
+    int newSize = valuesSize * 2 > 32 ? valuesSize * 2 : 32;
+    if (newSize < length){
+        newSize = length;
+    }
+    uint8_t * valuesMem = (uint8_t *) allocate(values, valuesSize, newSize);
+    if (valuesMem == NULL){
+        error = ALLOCFAILED;
+        return false;
+    }
+    values = valuesMem;
+    valuesSize = newSize;
+    return true;
+}
+
+bool OSCMessage::reserveAddress(int length){
+    //an interned address belongs to the table, so the message needs its own
+    if (addressInterned){
+        releaseAddress();
+    }
+    if (length <= addressSize){
+        return true;
+    }
+    if (storageFixed || storageLimited){
+        error = BUFFER_FULL;
+        return false;
+    }
+    int newSize = addressSize * 2 > 16 ? addressSize * 2 : 16;
+    if (newSize < length){
+        newSize = length;
+    }
+    char * addressMem = (char *) allocate(address, addressSize, newSize);
+    if (addressMem == NULL){
+        error = ALLOCFAILED;
+        return false;
+    }
+    address = addressMem;
+    addressSize = newSize;
+    return true;
+}
+
+//borrowed strings and blobs are stored under these type tags as a pointer and a length
+//they are encoded as 's' and 'b' straight from the caller's memory
+#define BORROWED_STRING '\x01'
+#define BORROWED_BLOB '\x02'
+struct OSCBorrowed {
+    const uint8_t * data;
+    uint32_t length;
+};
+
+//the number of bytes a borrowed string or blob takes up in the values
+#define BORROWED_SIZE ((int) (sizeof(OSCBorrowed) + padSize(sizeof(OSCBorrowed))))
+
+//the number of bytes a datum takes up in the values
+static inline int storedSize(char type, const uint8_t * value, int remaining){
+    if (type == BORROWED_STRING || type == BORROWED_BLOB){
+        return BORROWED_SIZE;
+    }
+    return oscArgumentSize(type, value, remaining);
+}
+
+//the type a datum is sent as
+static inline char wireType(char type){
+    if (type == BORROWED_STRING){
+        return 's';
+    } else if (type == BORROWED_BLOB){
+        return 'b';
+    }
+    return type;
+}
+
+//the number of bytes a borrowed string or blob adds when it's encoded
+static inline int borrowedExtraSize(char type, uint32_t length){
+    int encodedSize = length + padSize(length);
+    if (type == BORROWED_BLOB){
+        encodedSize += 4;
+    }
+    return encodedSize - BORROWED_SIZE;
+}
+
+uint8_t * OSCMessage::place(int position, char type, int size){
+    needArguments();
+    if (position == dataCount){
+        //add it to the end
+        if (!reserveTypes(dataCount + 1) || !reserveValues(valuesLength + size)){
+            return NULL;
+        }
+        uint8_t * value = values + valuesLength;
+        types[dataCount++] = type;
+        valuesLength += size;
+        return value;
+    } else if (position >= 0 && position < dataCount){
+        //replace the datum, moving the ones after it
+        int offset = valueOffset(position);
+        int oldSize = storedSize(types[position], values + offset, valuesLength - offset);
+        if (!reserveValues(valuesLength - oldSize + size)){
+            return NULL;
+        }
+        if (types[position] == BORROWED_STRING || types[position] == BORROWED_BLOB){
+            //it's not borrowed anymore
+            OSCBorrowed borrowed;
+            memcpy(&borrowed, values + offset, sizeof(borrowed));
+            borrowedCount--;
+            borrowedExtra -= borrowedExtraSize(types[position], borrowed.length);
+        }
+        if (valuesLength - offset - oldSize > 0){
+            memmove(values + offset + size, values + offset + oldSize, valuesLength - offset - oldSize);
+        }
+        valuesLength += size - oldSize;
+        types[position] = type;
+        //the data after it have moved
+        cursorPosition = 0;
+        cursorOffset = 0;
+        return values + offset;
+    } else {
+        //else out of bounds error
+        error = INDEX_OUT_OF_BOUNDS;
+        return NULL;
+    }
+}
+
+int OSCMessage::valueOffset(int position){
+    needArguments();
+    if (position < 0 || position >= dataCount){
+        return -1;
+    }
+    //start over if the position is behind the cursor
+    if (position < cursorPosition){
+        cursorPosition = 0;
+        cursorOffset = 0;
+    }
+    while (cursorPosition < position){
+        cursorOffset += storedSize(types[cursorPosition], values + cursorOffset, valuesLength - cursorOffset);
+        cursorPosition++;
+    }
+    return cursorOffset;
+}
+
+/*=============================================================================
+	SETTING DATA
+=============================================================================*/
+
+static inline void write32(uint8_t * value, uint32_t i){
+    i = BigEndian(i);
+    memcpy(value, &i, 4);
+}
+
+static inline void write64(uint8_t * value, uint64_t l){
+    l = BigEndian(l);
+    memcpy(value, &l, 8);
+}
+
+void OSCMessage::set(int position, const char * s){
+    int len = strlen(s) + 1;
+    uint8_t * value = place(position, 's', len + padSize(len));
+    if (value != NULL){
+        memcpy(value, s, len);
+        memset(value + len, 0, padSize(len));
+    }
+}
+
+void OSCMessage::set(int position, int i){
+    set(position, (int32_t) i);
+}
+
+void OSCMessage::set(int position, int32_t i){
+    uint8_t * value = place(position, 'i', 4);
+    if (value != NULL){
+        write32(value, (uint32_t) i);
+    }
+}
+
+void OSCMessage::set(int position, float f){
+    uint8_t * value = place(position, 'f', 4);
+    if (value != NULL){
+        union {
+            float f;
+            uint32_t i;
+        } u;
+        u.f = f;
+        write32(value, u.i);
+    }
+}
+
+void OSCMessage::set(int position, double d){
+    //if it's not 8 bytes it's not a true double
+    if (sizeof(double) != 8){
+        set(position, (float) d);
+        return;
+    }
+    uint8_t * value = place(position, 'd', 8);
+    if (value != NULL){
+        union {
+            double d;
+            uint64_t l;
+        } u;
+        u.d = d;
+        write64(value, u.l);
+    }
+}
+
+void OSCMessage::set(int position, bool b){
+    place(position, b ? 'T' : 'F', 0);
+}
+
+void OSCMessage::set(int position, uint64_t t){
+    uint8_t * value = place(position, 't', 8);
+    if (value != NULL){
+        write64(value, t);
+    }
+}
+
+void OSCMessage::set(int position, uint8_t * blob, int length){
+    uint8_t * value = place(position, 'b', 4 + length + padSize(length));
+    if (value != NULL){
+        //the size goes in front of the blob
+        write32(value, (uint32_t) length);
+        memcpy(value + 4, blob, length);
+        memset(value + 4 + length, 0, padSize(length));
+    }
+}
+
+//size() counts the arguments lazy decoding left in the packet, which come first
+OSCMessage& OSCMessage::add(const char * s){
+    set(size(), s);
+    return *this;
+}
+
+OSCMessage& OSCMessage::add(int i){
+    set(size(), i);
+    return *this;
+}
+
+OSCMessage& OSCMessage::add(int32_t i){
+    set(size(), i);
+    return *this;
+}
+
+OSCMessage& OSCMessage::add(float f){
+    set(size(), f);
+    return *this;
+}
+
+OSCMessage& OSCMessage::add(double d){
+    set(size(), d);
+    return *this;
+}
+
+OSCMessage& OSCMessage::add(bool b){
+    set(size(), b);
+    return *this;
+}
+
+OSCMessage& OSCMessage::add(uint64_t t){
+    set(size(), t);
+    return *this;
+}
+
+OSCMessage& OSCMessage::add(uint8_t * blob, int length){
+    set(size(), blob, length);
+    return *this;
+}
+
+void OSCMessage::setBorrowed(int position, char type, const uint8_t * data, int length){
+    uint8_t * value = place(position, type, BORROWED_SIZE);
+    if (value != NULL){
+        OSCBorrowed borrowed;
+        borrowed.data = data;
+        borrowed.length = length;
+        memset(value, 0, BORROWED_SIZE);
+        memcpy(value, &borrowed, sizeof(borrowed));
+        borrowedCount++;
+        borrowedExtra += borrowedExtraSize(type, length);
+    }
+}
+
+OSCMessage& OSCMessage::addBorrowed(const char * s){
+    setBorrowed(size(), BORROWED_STRING, (const uint8_t *) s, strlen(s) + 1);
+    return *this;
+}
+
+OSCMessage& OSCMessage::addBorrowed(const uint8_t * blob, int length){
+    setBorrowed(size(), BORROWED_BLOB, blob, length);
+    return *this;
+}
+
+void OSCMessage::addWords(char type, const void * words, int n){
+    needArguments();
+    if (n <= 0 || !reserveTypes(dataCount + n) || !reserveValues(valuesLength + n * 4)){
+        return;
+    }
+    memset(types + dataCount, type, n);
+    oscBigEndianCopy32(values + valuesLength, words, n);
+    dataCount += n;
+    valuesLength += n * 4;
+}
+
+OSCMessage& OSCMessage::addFloats(const float * f, int n){
+    addWords('f', f, n);
+    return *this;
+}
+
+OSCMessage& OSCMessage::addInts(const int32_t * i, int n){
+    addWords('i', i, n);
+    return *this;
 }
 
 /*=============================================================================
 	GETTING DATA
 =============================================================================*/
 
-OSCData * OSCMessage::getOSCData(int position){
-	if (position < dataCount){
-		OSCData * datum = data[position];
-		return datum;
-	} else {
-		error = INDEX_OUT_OF_BOUNDS;
+uint8_t * OSCMessage::getValue(int position, char type){
+    int offset = valueOffset(position);
+    if (offset < 0){
+        error = INDEX_OUT_OF_BOUNDS;
         return NULL;
-	}
+    }
+    if (hasError() || types[position] != type){
+        return NULL;
+    }
+    return values + offset;
+}
+
+static inline uint32_t read32(const uint8_t * value){
+    union {
+        uint32_t i;
+        uint8_t b[4];
+    } u;
+    memcpy(u.b, value, 4);
+    return BigEndian(u.i);
+}
+
+static inline uint64_t read64(const uint8_t * value){
+    union {
+        uint64_t l;
+        uint8_t b[8];
+    } u;
+    memcpy(u.b, value, 8);
+    return BigEndian(u.l);
+}
+
+OSCData * OSCMessage::getOSCData(int position){
+    delete datumCopy;
+    datumCopy = NULL;
+    switch (getType(position)){
+        case 'i':
+            datumCopy = new OSCData(getInt(position));
+            break;
+        case 'f':
+            datumCopy = new OSCData(getFloat(position));
+            break;
+        case 'd':
+            datumCopy = new OSCData(getDouble(position));
+            break;
+        case 't':
+            datumCopy = new OSCData(getTime(position));
+            break;
+        case 'T':
+        case 'F':
+            datumCopy = new OSCData(getBoolean(position));
+            break;
+        case 's':
+            datumCopy = new OSCData(getStringPtr(position));
+            break;
+        case 'b':
+            datumCopy = new OSCData((uint8_t *) getBlobPtr(position), getBlobLength(position));
+            break;
+    }
+    return datumCopy;
 }
 
 int32_t OSCMessage::getInt(int position){
-	OSCData * datum = getOSCData(position);
-	if (!hasError()){
-		return datum->getInt();
+    uint8_t * value = getValue(position, 'i');
+    if (value != NULL){
+        return (int32_t) read32(value);
     } else {
-        return NULL;
+        return 0;
     }
 }
+
 uint64_t OSCMessage::getTime(int position){
-	OSCData * datum = getOSCData(position);
-	if (!hasError()){
-		return datum->getTime();
+    uint8_t * value = getValue(position, 't');
+    if (value != NULL){
+        return read64(value);
     } else {
-        return NULL;
+        return 0;
     }
 }
+
 float OSCMessage::getFloat(int position){
-	OSCData * datum = getOSCData(position);
-	if (!hasError()){
-		return datum->getFloat();
+    uint8_t * value = getValue(position, 'f');
+    if (value != NULL){
+        union {
+            uint32_t i;
+            float f;
+        } u;
+        u.i = read32(value);
+        return u.f;
     } else {
-        return NULL;
+        return 0;
     }
 }
 
 double OSCMessage::getDouble(int position){
-	OSCData * datum = getOSCData(position);
-	if (!hasError()){
-		return datum->getDouble();
+    uint8_t * value = getValue(position, 'd');
+    if (value != NULL){
+        union {
+            uint64_t l;
+            double d;
+        } u;
+        u.l = read64(value);
+        return u.d;
     } else {
+        return 0;
+    }
+}
+
+bool OSCMessage::getBoolean(int position){
+    //'T' and 'F' have no value to point at, the type tag is the value
+    if (valueOffset(position) < 0){
+        error = INDEX_OUT_OF_BOUNDS;
+        return false;
+    }
+    return !hasError() && types[position] == 'T';
+}
+
+int OSCMessage::getWords(int position, char type, void * words, int n){
+    uint8_t * value = getValue(position, type);
+    if (value == NULL){
+        return 0;
+    }
+    //the run ends at the first datum of another type
+    int count = 1;
+    while (count < n && position + count < dataCount && types[position + count] == type){
+        count++;
+    }
+    oscBigEndianCopy32(words, value, count);
+    //the next read carries on after the run
+    cursorPosition = position + count;
+    cursorOffset = value - values + count * 4;
+    return count;
+}
+
+int OSCMessage::getFloats(int position, float * f, int n){
+    return n > 0 ? getWords(position, 'f', f, n) : 0;
+}
+
+int OSCMessage::getInts(int position, int32_t * i, int n){
+    return n > 0 ? getWords(position, 'i', i, n) : 0;
+}
+
+const uint8_t * OSCMessage::getBytes(int position, char type, int * length){
+    int offset = valueOffset(position);
+    if (offset < 0){
+        error = INDEX_OUT_OF_BOUNDS;
         return NULL;
     }
+    if (hasError()){
+        return NULL;
+    }
+    const uint8_t * value = values + offset;
+    char stored = types[position];
+    if (stored == type){
+        if (type == 's'){
+            *length = strlen((const char *) value) + 1;
+            return value;
+        } else {
+            //the size is in front of the blob
+            *length = read32(value);
+            return value + 4;
+        }
+    } else if (wireType(stored) == type && stored != type){
+        OSCBorrowed borrowed;
+        memcpy(&borrowed, value, sizeof(borrowed));
+        *length = borrowed.length;
+        return borrowed.data;
+    }
+    return NULL;
 }
 
 int OSCMessage::getString(int position, char * buffer, int bufferSize){
-	OSCData * datum = getOSCData(position);
-	if (!hasError()){
-        //the number of bytes to copy is the smaller between the buffer size and the datum's byte length
-        int copyBytes = bufferSize < datum->bytes? bufferSize : datum->bytes;
-		return datum->getString(buffer, copyBytes);
-    } else {
-        return NULL;
+    int strSize;
+    const uint8_t * str = getBytes(position, 's', &strSize);
+    //only if the whole string fits
+    if (str != NULL && strSize <= bufferSize){
+        memcpy(buffer, str, strSize);
+        return strSize;
     }
+    return 0;
 }
 
 int OSCMessage::getBlob(int position, uint8_t * buffer, int bufferSize){
-	OSCData * datum = getOSCData(position);
-	if (!hasError()){
-        //the number of bytes to copy is the smaller between the buffer size and the datum's byte length
-        int copyBytes = bufferSize < datum->bytes? bufferSize : datum->bytes;
-		return datum->getBlob(buffer, copyBytes);
-    } else {
-        return NULL;
+    int length;
+    const uint8_t * blob = getBytes(position, 'b', &length);
+    //the size is copied along with the contents
+    if (blob != NULL && length + 4 <= bufferSize){
+        write32(buffer, (uint32_t) length);
+        memcpy(buffer + 4, blob, length);
+        return length + 4;
     }
+    return 0;
+}
+
+const char * OSCMessage::getStringPtr(int position){
+    int length;
+    return (const char *) getBytes(position, 's', &length);
+}
+
+const uint8_t * OSCMessage::getBlobPtr(int position){
+    int length;
+    return getBytes(position, 'b', &length);
+}
+
+int OSCMessage::getBlobLength(int position){
+    int length;
+    if (getBytes(position, 'b', &length) != NULL){
+        return length;
+    }
+    return 0;
+}
+
+bool OSCMessage::getArguments(const char * _types, void * target){
+    int count = strlen(_types);
+    if (lazyTypes != NULL && dataCount == 0){
+        //straight out of the packet, without decoding the arguments into the message
+        return count == lazyCount && memcmp(lazyTypes, _types, count) == 0 && oscDecodeStruct(_types, lazyArguments, lazyLength, target);
+    }
+    needArguments();
+    //borrowed strings and blobs have their own type tags, so they never match
+    return count == dataCount && memcmp(types, _types, count) == 0 && oscDecodeStruct(_types, values, valuesLength, target);
 }
 
 char OSCMessage::getType(int position){
-	OSCData * datum = getOSCData(position);
+    if (valueOffset(position) < 0){
+        error = INDEX_OUT_OF_BOUNDS;
+        return 0;
+    }
 	if (!hasError()){
-		return datum->type;
+		return wireType(types[position]);
 	} else {
-        return NULL;
+        return 0;
     }
 }
 
 int OSCMessage::getDataCount(){
-    return dataCount;
+    return dataCount + lazyCount;
 }
 
 int OSCMessage::getDataLength(int position){
-    OSCData * datum = getOSCData(position);
-    if (!hasError()){
-        return datum->bytes;
-    } else {
-        return 0;
+    char type = getType(position);
+    //the length without the padding
+    switch (type){
+        case 's':
+            return strlen(getStringPtr(position)) + 1;
+        case 'b':
+            return getBlobLength(position) + 4;
+        case 0:
+            return 0;
+        default:
+            return oscArgumentSize(type, values + valueOffset(position), valuesLength - valueOffset(position));
     }
 }
 
@@ -203,12 +931,7 @@ int OSCMessage::getDataLength(int position){
 =============================================================================*/
 
 bool OSCMessage::testType(int position, char type){
-	OSCData * datum = getOSCData(position);
-	if (!hasError()){
-		return datum->type == type;
-	} else {
-		return false;
-	}
+	return getType(position) == type;
 }
 
 bool OSCMessage::isInt(int position){
@@ -243,7 +966,6 @@ bool OSCMessage::isBoolean(int position){
 	return testType(position, 'T') || testType(position, 'F');
 }
 
-
 /*=============================================================================
 	PATTERN MATCHING
 =============================================================================*/
@@ -288,6 +1010,39 @@ bool OSCMessage::route(const char * pattern, void (*callback)(OSCMessage &, int)
 	}
 }
 
+int OSCMessage::match(const OSCPattern & pattern, int addr_offset){
+	if (address == NULL){
+		return 0;
+	}
+	return pattern.match(address + addr_offset);
+}
+
+bool OSCMessage::fullMatch(const OSCPattern & pattern, int addr_offset){
+	if (address == NULL){
+		return false;
+	}
+	return pattern.fullMatch(address + addr_offset);
+}
+
+bool OSCMessage::dispatch(const OSCPattern & pattern, void (*callback)(OSCMessage &), int addr_offset){
+	if (fullMatch(pattern, addr_offset)){
+		callback(*this);
+		return true;
+	} else {
+		return false;
+	}
+}
+
+bool OSCMessage::route(const OSCPattern & pattern, void (*callback)(OSCMessage &, int), int initial_offset){
+	int match_offset = match(pattern, initial_offset);
+	if (match_offset>0){
+		callback(*this, match_offset + initial_offset);
+		return true;
+	} else {
+		return false;
+	}
+}
+
 /*=============================================================================
     ADDRESS
  =============================================================================*/
@@ -312,38 +1067,83 @@ int OSCMessage::getAddressLength(int offset) {
 }
 
 void OSCMessage::setAddress(const char * _address){
+    if (addresses != NULL && !storageFixed && !storageLimited){
+        uint32_t hash = OSCAddressTable::hash(_address);
+        const char * interned = addresses->intern(_address, hash);
+        if (interned != NULL){
+            releaseAddress();
+            address = (char *) interned;
+            addressSize = 0;
+            addressInterned = true;
+            addressHash = hash;
+            addressHashed = true;
+            return;
+        }
+        //the table is full, so it's copied like any other
+    }
+    addressHashed = false;
+    int length = strlen(_address) + 1;
+    //reuse the memory if it fits
+    if (address != NULL && length <= addressSize){
+        memmove(address, _address, length);
+        return;
+    }
+    if (storageFixed || storageLimited){
+        error = BUFFER_FULL;
+        return;
+    }
     //free the previous address
-    free(address); // are we sure address was allocated?
+    releaseAddress();
     //copy the address
-	char * addressMemory = (char *) malloc( (strlen(_address) + 1) * sizeof(char) );
+	char * addressMemory = (char *) allocate(NULL, 0, length * sizeof(char) );
 	if (addressMemory == NULL){
 		error = ALLOCFAILED;
 		address = NULL;
+		addressSize = 0;
 	} else {
 		strcpy(addressMemory, _address);
 		address = addressMemory;
+		addressSize = length;
 	}
 }
 
+void OSCMessage::releaseAddress(){
+    if (!addressInterned){
+        release(address);
+    }
+    address = NULL;
+    addressSize = 0;
+    addressInterned = false;
+    addressHashed = false;
+}
+
+void OSCMessage::setAddressTable(OSCAddressTable * table){
+    addresses = table;
+}
+
+uint32_t OSCMessage::getAddressHash(){
+    if (!addressHashed && address != NULL){
+        addressHash = OSCAddressTable::hash(address);
+        addressHashed = true;
+    }
+    return addressHash;
+}
+
+const char * OSCMessage::getInternedAddress(){
+    return addressInterned ? address : NULL;
+}
+
 /*=============================================================================
 	SIZE
 =============================================================================*/
 
-#ifdef SLOWpadcalculation
-int OSCMessage::padSize(int _bytes) {
-    int padSize = (_bytes + 4) % 4;
-    return padSize;
-}
-#else
-static inline  int padSize(int bytes) { return (bytes + 4) % 4; }
-#endif
-
-//returns the number of OSCData in the OSCMessage
+//returns the number of data in the OSCMessage
 int OSCMessage::size(){
-	return dataCount;
+	return dataCount + lazyCount;
 }
 
 int OSCMessage::bytes(){
+    needArguments();
     int messageSize = 0;
     //send the address
     int addrLen = strlen(address) + 1;
@@ -361,12 +1161,8 @@ int OSCMessage::bytes(){
          typePad = 4; // to make sure the type string is null terminated
     }
     messageSize+=typePad;
-    //then the data
-    for (int i = 0; i < dataCount; i++){
-        OSCData * datum = getOSCData(i);
-        messageSize+=datum->bytes;
-        messageSize += padSize(datum->bytes);
-    }
+    //then the data, which is already padded
+    messageSize += valuesLength + borrowedExtra;
     return messageSize;
 }
 
@@ -375,13 +1171,7 @@ int OSCMessage::bytes(){
 =============================================================================*/
 
 bool OSCMessage::hasError(){
-    bool retError = error != OSC_OK;
-    //test each of the data
-    for (int i = 0; i < dataCount; i++){
-        OSCData * datum = getOSCData(i);
-        retError |= datum->error != OSC_OK;
-    }
-	return retError;
+	return error != OSC_OK;
 }
 
 OSCErrorCode OSCMessage::getError(){
@@ -393,75 +1183,141 @@ OSCErrorCode OSCMessage::getError(){
  =============================================================================*/
 
 void OSCMessage::send(Print &p){
+    needArguments();
     //don't send a message with errors
     if (hasError()){
         return;
     }
-    uint8_t nullChar = '\0';
-    //send the address
-    int addrLen = strlen(address) + 1;
-    //padding amount
-    int addrPad = padSize(addrLen);
-    //write it to the stream
-    p.write((uint8_t *) address, addrLen);
-    //add the padding
-    while(addrPad--){
-        p.write(nullChar);
+    uint8_t buffer[OSC_SEND_BUFFER_SIZE];
+    OSCEncoder encoder(p, buffer, OSC_SEND_BUFFER_SIZE);
+    encode(encoder);
+    encoder.flush();
+}
+
+size_t OSCMessage::encode(uint8_t * buffer, size_t capacity){
+    needArguments();
+    //don't encode a message with errors
+    if (hasError()){
+        return 0;
     }
-    //add the comma seperator
-    p.write((uint8_t) ',');
-    //add the types
-#ifdef PAULSSUGGESTION
-    // Paul suggested buffering on the stack
-    // to improve performance. The problem is this could exhaust the stack
-    // for long complex messages
-    {
-        uint8_t typstr[dataCount];
-    
+    size_t messageSize = bytes();
+    if (messageSize <= capacity){
+        OSCEncoder encoder(buffer, capacity);
+        encode(encoder);
+    }
+    return messageSize;
+}
+
+void OSCMessage::encode(OSCEncoder &encoder){
+    needArguments();
+    //the address
+    int addrLen = strlen(address) + 1;
+    encoder.write((uint8_t *) address, addrLen);
+    encoder.pad(padSize(addrLen));
+    //the comma seperator and the types
+    encoder.write((uint8_t) ',');
+    if (borrowedCount == 0){
+        encoder.write((uint8_t *) types, dataCount);
+    } else {
         for (int i = 0; i < dataCount; i++){
-            typstr[i] =  getType(i);
+            encoder.write((uint8_t) wireType(types[i]));
         }
-        p.write(typstr,dataCount);
     }
-#else
-    for (int i = 0; i < dataCount; i++){
-        p.write((uint8_t) getType(i));
-    }
-#endif
     //pad the types
     int typePad = padSize(dataCount + 1); // 1 is for the comma
     if (typePad == 0){
-            typePad = 4;  // This is because the type string has to be null terminated
+        typePad = 4;  // This is because the type string has to be null terminated
     }
-    while(typePad--){
-        p.write(nullChar);
+    encoder.pad(typePad);
+    //the data is stored the way it is sent
+    if (borrowedCount == 0){
+        encoder.write(values, valuesLength);
+        return;
     }
-    //write the data
+    //except for borrowed data, which is written from where it is
+    int offset = 0;
+    int stored = 0;
     for (int i = 0; i < dataCount; i++){
-        OSCData * datum = getOSCData(i);
-        if ((datum->type == 's') || (datum->type == 'b')){
-            p.write(datum->data.b, datum->bytes);
-            int dataPad = padSize(datum->bytes);
-            while(dataPad--){
-                p.write(nullChar);
+        char type = types[i];
+        if (type == BORROWED_STRING || type == BORROWED_BLOB){
+            encoder.write(values + stored, offset - stored);
+            OSCBorrowed borrowed;
+            memcpy(&borrowed, values + offset, sizeof(borrowed));
+            if (type == BORROWED_BLOB){
+                uint32_t length = BigEndian(borrowed.length);
+                encoder.write((uint8_t *) &length, 4);
             }
-        } else if (datum->type == 'd'){
-            double d = BigEndian(datum->data.d);
-            uint8_t * ptr = (uint8_t *) &d;
-            p.write(ptr, 8);
-        } else if (datum->type == 't'){
-            uint64_t d = BigEndian(datum->data.l);
-            uint8_t * ptr = (uint8_t *)    &d;
-            p.write(ptr, 8);
-
-        } else if (datum->type == 'T' || datum->type == 'F')
-                    { }
-        else { // float or int
-            uint32_t i = BigEndian(datum->data.i);
-            uint8_t * ptr = (uint8_t *) &i;
-            p.write(ptr, datum->bytes);
+            encoder.write(borrowed.data, borrowed.length);
+            encoder.pad(padSize(borrowed.length));
+            offset += BORROWED_SIZE;
+            stored = offset;
+        } else {
+            offset += storedSize(type, values + offset, valuesLength - offset);
         }
     }
+    encoder.write(values + stored, valuesLength - stored);
+}
+
+/*=============================================================================
+    ENCODER
+ =============================================================================*/
+
+OSCEncoder::OSCEncoder(uint8_t * _buffer, size_t _capacity){
+    buffer = _buffer;
+    capacity = _capacity;
+    length = 0;
+    total = 0;
+    out = NULL;
+}
+
+OSCEncoder::OSCEncoder(Print &p, uint8_t * _buffer, size_t _capacity){
+    buffer = _buffer;
+    capacity = _capacity;
+    length = 0;
+    total = 0;
+    out = &p;
+}
+
+void OSCEncoder::write(const uint8_t * bytes, size_t len){
+    if (len == 0){
+        return;
+    }
+    total += len;
+    if (length + len > capacity){
+        if (out == NULL){
+            //out of room, only count the bytes
+            length = capacity;
+            return;
+        }
+        flush();
+        //too big to stage, hand it over directly
+        if (len > capacity){
+            out->write(bytes, len);
+            return;
+        }
+    }
+    memcpy(buffer + length, bytes, len);
+    length += len;
+}
+
+void OSCEncoder::write(uint8_t b){
+    write(&b, 1);
+}
+
+void OSCEncoder::pad(int count){
+    static const uint8_t nulls[4] = {0, 0, 0, 0};
+    write(nulls, count);
+}
+
+void OSCEncoder::flush(){
+    if (out != NULL && length > 0){
+        out->write(buffer, length);
+    }
+    length = 0;
+}
+
+size_t OSCEncoder::size(){
+    return total;
 }
 
 /*=============================================================================
@@ -473,6 +1329,12 @@ void OSCMessage::fill(uint8_t incomingByte){
 }
 
 void OSCMessage::fill(uint8_t * incomingBytes, int length){
+    //only a fill which starts a message can hold the whole of it
+    if (decodeState == STANDBY){
+        if (decodePacket(incomingBytes, length)){
+            return;
+        }
+    }
     while (length--){
         decode(*incomingBytes++);
     }
@@ -482,229 +1344,280 @@ void OSCMessage::fill(uint8_t * incomingBytes, int length){
     DECODING
  =============================================================================*/
 
-void OSCMessage::decodeAddress(){
-    setAddress((char *) incomingBuffer);
+bool OSCMessage::decodePacket(uint8_t * packet, int length){
+    //lazy decoding leaves checking the arguments until they're read
+    OSCMessageView view(packet, length, !lazyDecoding);
+    if (view.hasError()){
+        return false;
+    }
+    int count = view.size();
+    //only the types the byte-wise decoder knows about
+    for (int i = 0; i < count; i++){
+        switch (view.types[i]){
+            case 'i': case 'f': case 'd': case 't':
+            case 's': case 'b': case 'T': case 'F':
+                break;
+            default:
+                return false;
+        }
+    }
+    if (!passesFilter(view.address)){
+        error = FILTERED;
+        decodeState = DONE;
+        return true;
+    }
+    //change the error from invalid message
+    error = OSC_OK;
+    setAddress(view.address);
+    if (error != OSC_OK){
+        return true;
+    }
+    //the data is already laid out the way it's stored
+    int argumentsLength = packet + length - view.arguments;
+    if (count > 0 && lazyDecoding){
+        lazyTypes = view.types;
+        lazyArguments = view.arguments;
+        lazyCount = count;
+        lazyLength = argumentsLength;
+    } else if (count > 0 && reserveTypes(dataCount + count) && reserveValues(valuesLength + argumentsLength)){
+        memcpy(types + dataCount, view.types, count);
+        //only 'T' 'F' 'N' 'I' leaves nothing to copy, and maybe nowhere to copy it
+        if (argumentsLength > 0){
+            memcpy(values + valuesLength, view.arguments, argumentsLength);
+        }
+        dataCount += count;
+        valuesLength += argumentsLength;
+    }
+    decodeState = DONE;
+    return true;
+}
+
+void OSCMessage::setLazyDecoding(bool lazy){
+    lazyDecoding = lazy;
+}
+
+bool OSCMessage::decodeArguments(){
+    if (lazyTypes == NULL){
+        return true;
+    }
+    const char * lazy = lazyTypes;
+    int count = lazyCount;
+    lazyTypes = NULL;
+    lazyCount = 0;
+    //each of the arguments has to fit in what's left of the packet, and fill it
+    const uint8_t * ptr = lazyArguments;
+    const uint8_t * end = lazyArguments + lazyLength;
+    for (int i = 0; i < count; i++){
+        int argSize = oscArgumentSize(lazy[i], ptr, end - ptr);
+        if (argSize < 0){
+            error = INVALID_OSC;
+            return false;
+        }
+        ptr += argSize;
+    }
+    if (ptr != end){
+        error = INVALID_OSC;
+        return false;
+    }
+    if (!reserveTypes(dataCount + count) || !reserveValues(valuesLength + lazyLength)){
+        return false;
+    }
+    memcpy(types + dataCount, lazy, count);
+    //only 'T' 'F' 'N' 'I' leaves nothing to copy, and maybe nowhere to copy it
+    if (lazyLength > 0){
+        memcpy(values + valuesLength, lazyArguments, lazyLength);
+    }
+    dataCount += count;
+    valuesLength += lazyLength;
+    return true;
+}
+
+void OSCMessage::setFilter(const char * const * patterns, int count){
+    filter = patterns;
+    filterCount = patterns != NULL ? count : 0;
+}
+
+bool OSCMessage::passesFilter(const char * _address){
+    if (filter == NULL){
+        return true;
+    }
+    //the whole pattern has to match, up to a '/' or the end of the address
+    for (int i = 0; i < filterCount; i++){
+        int patternOffset;
+        int addressOffset;
+        int ret = osc_match(filter[i], _address, &patternOffset, &addressOffset);
+        if ((ret & OSC_MATCH_PATTERN_COMPLETE) && (_address[addressOffset] == '\0' || _address[addressOffset] == '/')){
+            return true;
+        }
+    }
+    return false;
+}
+
+void OSCMessage::decodeAddress(uint8_t incomingByte){
+    //written straight into the address, which is kept null terminated as it grows
+    if (!reserveAddress(decodeLength + (incomingByte != 0 ? 2 : 1))){
+        decodeState = DONE;
+        return;
+    }
+    address[decodeLength++] = incomingByte;
+    if (incomingByte != 0){
+        address[decodeLength] = '\0';
+        return;
+    }
+    //end of the address
+    decodeState = ADDRESS_PADDING;
+    addressHashed = false;
+    //the rest of a message which is turned away is ignored without being stored
+    if (!passesFilter(address)){
+        error = FILTERED;
+        decodeState = DONE;
+        return;
+    }
     //change the error from invalide message
     error = OSC_OK;
-    clearIncomingBuffer();
+    //the table keeps its own copy
+    if (addresses != NULL && !storageFixed && !storageLimited){
+        setAddress(address);
+    }
 }
 
 void OSCMessage::decodeType(uint8_t incomingByte){
-    char type = incomingByte;
-    add(type);
+    //the comma isn't counted
+    decodeLength++;
+    if (incomingByte != 0){
+        //kept past the end of the data, each one is added again as its data is decoded
+        if (!reserveTypes(decodeCount + 1)){
+            decodeState = DONE;
+            return;
+        }
+        types[decodeCount++] = incomingByte;
+        return;
+    }
+    //the comma, the type tags and the null are padded to 4 bytes
+    if (padSize(decodeLength + 1) == 0){
+        decodeState = DATA;
+        decodeLength = 0;
+    } else {
+        decodeState = TYPES_PADDING;
+    }
+    //invalid until all of the data has arrived
+    if (decodeCount > dataCount){
+        error = INVALID_OSC;
+    }
+    nextDecodePosition();
+}
+
+void OSCMessage::nextDecodePosition(){
+    //booleans are only a type, there is nothing to wait for
+    while (dataCount < decodeCount){
+        char type = types[dataCount];
+        if (type == 'T' || type == 'F'){
+            add(type == 'T');
+        } else {
+            break;
+        }
+    }
+    //ignore the rest once everything is decoded
+    if (dataCount >= decodeCount){
+        decodeState = DONE;
+        if (error == INVALID_OSC){
+            error = OSC_OK;
+        }
+        return;
+    }
+    //the size of a string or blob isn't known until some of it has arrived
+    switch (types[dataCount]){
+        case 'i':
+        case 'f':
+            decodeSize = 4;
+            break;
+        case 'd':
+        case 't':
+            decodeSize = 8;
+            break;
+        case 's':
+        case 'b':
+            decodeSize = 0;
+            break;
+        default:
+            //can't be decoded
+            error = INVALID_OSC;
+            decodeState = DONE;
+            break;
+    }
 }
 
 void OSCMessage::decodeData(uint8_t incomingByte){
-    //get the first OSCData to re-set
-    for (int i = 0; i < dataCount; i++){
-        OSCData * datum = getOSCData(i);
-        if (datum->error == INVALID_OSC){
-            //set the contents of datum with the data received
-            switch (datum->type){
-                case 'i':
-                    if (incomingBufferSize == 4){
-                        //parse the buffer as an int
-                        union {
-                            int32_t i;
-                            uint8_t b[4];
-                        } u;
-                        memcpy(u.b, incomingBuffer, 4);
-                        int32_t dataVal = BigEndian(u.i);
-                        set(i, dataVal);
-                        clearIncomingBuffer();
-                    }
-                    break;
-                case 'f':
-                    if (incomingBufferSize == 4){
-                        //parse the buffer as an int
-                        union {
-                            float f;
-                            uint8_t b[4];
-                        } u;
-                        memcpy(u.b, incomingBuffer, 4);
-                        float dataVal = BigEndian(u.f);
-                        set(i, dataVal);
-                        clearIncomingBuffer();
-                    }
-                    break;
-                case 'd':
-                    if (incomingBufferSize == 8){
-                        //parse the buffer as an int
-                        union {
-                            double d;
-                            uint8_t b[8];
-                        } u;
-                        memcpy(u.b, incomingBuffer, 8);
-                        double dataVal = BigEndian(u.d);
-                        set(i, dataVal);
-                        clearIncomingBuffer();
-                    }
-                    break;
-                case 't':
-                    if (incomingBufferSize == 8){
-                        //parse the buffer as an int
-                        union {
-                            uint64_t d;
-                            uint8_t b[8];
-                        } u;
-                        memcpy(u.b, incomingBuffer, 8);
-                         uint64_t dataVal = BigEndian(u.d);
-                        set(i, dataVal);
-                        clearIncomingBuffer();
-                    }
-                    break;
-
-                case 's':
-                    if (incomingByte == 0){
-                        char * str = (char *) incomingBuffer;
-                        set(i, str);
-                        clearIncomingBuffer();
-//                        Serial.println("Move to state DATA_PADDING");
-                        decodeState = DATA_PADDING;
-                    }
-                    break;
-                case 'b':
-                    if (incomingBufferSize > 4){
-                        //compute the expected blob size
-                        union {
-                            uint32_t i;
-                            uint8_t b[4];
-                        } u;
-                        memcpy(u.b, incomingBuffer, 4);
-                        uint32_t blobLength = BigEndian(u.i);
-
-                        if (incomingBufferSize == blobLength + 4) {
-                            set(i, incomingBuffer + 4, blobLength);
-                            clearIncomingBuffer();
-
-                            if (padSize(datum->bytes) > 0) {
-//                                Serial.println("Move to state DATA_PADDING");
-                                decodeState = DATA_PADDING;
-                            }
-                        }
-                    }
-                    break;
+    //the data is stored the way it's sent, padding and all, so the bytes go straight in
+    if (!reserveValues(valuesLength + decodeLength + 1)){
+        decodeState = DONE;
+        return;
+    }
+    uint8_t * value = values + valuesLength;
+    value[decodeLength++] = incomingByte;
+    if (decodeSize == 0){
+        if (types[dataCount] == 's'){
+            //the null ends the string
+            if (incomingByte == 0){
+                decodeSize = decodeLength + padSize(decodeLength);
             }
-            //break out of the for loop once we've selected the first invalid message
-            break;
-        } 
+        } else if (decodeLength == 4){
+            //the blob's size comes first
+            uint32_t blobLength;
+            memcpy(&blobLength, value, 4);
+            blobLength = BigEndian(blobLength);
+            if (blobLength > (uint32_t) (INT_MAX - 8)){
+                error = INVALID_OSC;
+                decodeState = DONE;
+                return;
+            }
+            decodeSize = 4 + blobLength + padSize(blobLength);
+        }
+    }
+    if (decodeLength == decodeSize){
+        //the datum is complete, its type tag is already in place
+        dataCount++;
+        valuesLength += decodeSize;
+        decodeLength = 0;
+        nextDecodePosition();
     }
 }
 
-//does not validate the incoming OSC for correctness
 void OSCMessage::decode(uint8_t incomingByte){
-
-//    Serial.print(incomingBufferSize, DEC);
-//    Serial.print(" ");
-
-    addToIncomingBuffer(incomingByte);
-
     switch (decodeState){
         case STANDBY:
+            //anything before the address is ignored
             if (incomingByte == '/'){
-////                Serial.println("Move to state ADDRESS");
                 decodeState = ADDRESS;
+                decodeLength = 0;
+                decodeAddress(incomingByte);
             }
             break;
         case ADDRESS:
-			if (incomingByte == 0){
-				//end of the address
-				//decode the address
-                decodeAddress();
-				//next state
-////                Serial.println("Move to state ADDRESS_PADDING");
-				decodeState = ADDRESS_PADDING;
-			} 
-			break;
-		case ADDRESS_PADDING:
+            decodeAddress(incomingByte);
+            break;
+        case ADDRESS_PADDING:
             // it does not count the padding
-			if (incomingByte==','){
-                clearIncomingBuffer();
-////                Serial.println("Move to state TYPES");
-				decodeState = TYPES;
-			}
-			break;
-        case TYPES:
-            if (incomingByte != 0) {
-                decodeType(incomingByte);
-            } 
-            else {
-                if (padSize(incomingBufferSize + 1) == 0) {
-                    // No padding needed
-                    clearIncomingBuffer();
-//                    Serial.println("Move to state DATA");
-                    decodeState = DATA;
-                }
-                else {
-                    // Padding needed
-//                    Serial.println("Move to state TYPES_PADDING");
-                    decodeState = TYPES_PADDING;
-                }
+            if (incomingByte == ','){
+                decodeState = TYPES;
+                decodeLength = 0;
+                decodeCount = dataCount;
             }
             break;
+        case TYPES:
+            decodeType(incomingByte);
+            break;
         case TYPES_PADDING:
-            if (padSize(incomingBufferSize + 1) == 0) {
-                clearIncomingBuffer();
-//                Serial.println("Move to state DATA");
+            if (padSize(++decodeLength + 1) == 0){
                 decodeState = DATA;
+                decodeLength = 0;
             }
             break;
-		case DATA:
+        case DATA:
             decodeData(incomingByte);
             break;
-		case DATA_PADDING:{
-                // get the last valid data
-                for (int i = dataCount - 1; i >= 0; i--){
-                    OSCData * datum = getOSCData(i);
-                    if (datum->error == OSC_OK){
-                        // compute the padding size for the data
-                        int dataPad = padSize(datum->bytes);
-                        if (incomingBufferSize == dataPad){
-                            clearIncomingBuffer();
-//                            Serial.println("Move to state DATA");
-                            decodeState = DATA;
-                        }
-                        break;
-                    }
-                }
-            }
-			break;
-    }
-}
-
-
-/*=============================================================================
-    INCOMING BUFFER MANAGEMENT
- =============================================================================*/
-#define OSC_PREALLOCATE_SIZE 16
-void OSCMessage::addToIncomingBuffer(uint8_t incomingByte) {
-    // realloc some space for the new byte and stick it on the end
-    if (incomingBufferFree > 0)
-    {
-        incomingBuffer[incomingBufferSize++] = incomingByte;
-        incomingBufferFree--;
-    }
-    else
-    {
-        incomingBuffer = (uint8_t *) realloc ( incomingBuffer, incomingBufferSize + OSC_PREALLOCATE_SIZE);
-        if (incomingBuffer != NULL){
-            incomingBuffer[incomingBufferSize++] = incomingByte;
-            incomingBufferFree = OSC_PREALLOCATE_SIZE - 1;
-        } else {
-            error = ALLOCFAILED;
-        }
+        case DONE:
+            //everything has been decoded
+            break;
     }
 }
-
-void OSCMessage::clearIncomingBuffer() {
-    incomingBuffer = (uint8_t *) realloc ( incomingBuffer, OSC_PREALLOCATE_SIZE);
-
-    if (incomingBuffer != NULL) {
-        incomingBufferFree = OSC_PREALLOCATE_SIZE;
-    } else {
-        incomingBufferFree = 0;
-        error = ALLOCFAILED;
-    }
-
-    incomingBufferSize = 0;
-}
\ No newline at end of file
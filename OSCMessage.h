@@ -27,8 +27,62 @@
 #define OSCMESSAGE_h
 
 #include "OSCData.h"
+#include "OSCArena.h"
+#include "OSCPattern.h"
+#include "OSCAddressTable.h"
 #include <Print.h>
 
+//the number of bytes staged on the stack by send() before they are handed to the Print
+//messages which fit are sent with a single write
+#ifndef OSC_SEND_BUFFER_SIZE
+#if defined(__AVR__)
+#define OSC_SEND_BUFFER_SIZE 64
+#else
+#define OSC_SEND_BUFFER_SIZE 256
+#endif
+#endif
+
+/*=============================================================================
+	ENCODER
+
+	lays bytes out contiguously, either straight into a caller's buffer
+	or staged in a buffer that is flushed to a Print whenever it fills up
+=============================================================================*/
+
+class OSCEncoder
+{
+
+private:
+
+	uint8_t * buffer;
+	size_t capacity;
+	//the number of bytes in the buffer
+	size_t length;
+	//the number of bytes encoded so far
+	size_t total;
+	//where to flush to, NULL when encoding into memory
+	Print * out;
+
+public:
+
+	//encode into memory
+	//bytes past the capacity are counted but not written
+	OSCEncoder(uint8_t * buffer, size_t capacity);
+	//stage the bytes in the buffer on their way to the Print
+	OSCEncoder(Print & p, uint8_t * buffer, size_t capacity);
+
+	void write(const uint8_t * bytes, size_t len);
+	void write(uint8_t);
+	//writes 'count' null bytes
+	void pad(int count);
+
+	//hands any staged bytes to the Print
+	void flush();
+
+	//the number of bytes encoded so far
+	size_t size();
+};
+
 
 class OSCMessage
 {
@@ -37,6 +91,10 @@ private:
     
     //friends
 	friend class OSCBundle;
+	friend class OSCRouter;
+	friend class OSCStaticRouterBase;
+	friend class OSCRouteList;
+	template <int, int, int> friend class StaticOSCMessage;
 
 
 /*=============================================================================
@@ -46,14 +104,83 @@ private:
 	//the address
 	char * address;
 
-	//the data
-	OSCData ** data;
+	//the type tags, one char for each datum (not null terminated)
+	char * types;
+	int typesSize; // how many type tags there is room for
 
-	//the number of OSCData in the data array
+	//the data, laid out the way it is sent:
+	//big-endian, with strings and blobs inline, each padded to 4 bytes
+	uint8_t * values;
+	int valuesLength; // how many bytes are used
+	int valuesSize; // how many bytes are allocated
+
+	//the number of data in the message
 	int dataCount;
 
+	//the number of borrowed strings and blobs, which are stored as a pointer and a length
+	int borrowedCount;
+	//how many more bytes they take up encoded than stored
+	int borrowedExtra;
+
 	//error codes for potential runtime problems
 	OSCErrorCode error;
+
+	//the last datum looked up, so reading the data in order stays linear
+	int cursorPosition;
+	int cursorOffset;
+
+	//handed out by getOSCData
+	OSCData * datumCopy;
+
+	//where the address, type tags, data and incoming buffer come from
+	//NULL for the heap
+	OSCArena * arena;
+	//the arena was handed to the constructor, so empty() resets it
+	//the messages in a bundle leave that to the bundle
+	bool arenaOwner;
+
+	//empty() keeps the type tags and data buffers to be used again
+	bool keepStorage;
+
+	//the address, type tags and data live in buffers which belong to a StaticOSCMessage
+	//they are never reallocated or freed, running out of room sets BUFFER_FULL
+	bool storageFixed;
+	//the address, type tags and data are never grown past the room reserved for them
+	//like storageFixed, but the buffers belong to the message (a bundle's, see OSCBundle::reserveFixed)
+	bool storageLimited;
+	//how many bytes there is room for in the address
+	int addressSize;
+
+	//where addresses are interned, NULL to copy them
+	OSCAddressTable * addresses;
+	//the address belongs to the table, so it's never written to or freed
+	bool addressInterned;
+	//the address's hash, once addressHashed is set
+	uint32_t addressHash;
+	bool addressHashed;
+
+	//frees the address unless it's interned
+	void releaseAddress();
+
+	//a packet's arguments are left where they are until something reads them
+	bool lazyDecoding;
+	//the type tags and arguments still in the packet, NULL once they've been decoded
+	const char * lazyTypes;
+	const uint8_t * lazyArguments;
+	int lazyCount;
+	int lazyLength;
+
+	//the patterns a decoded address has to match one of, NULL to take every message
+	const char * const * filter;
+	int filterCount;
+	bool passesFilter(const char * address);
+
+	//decodes the arguments left in the packet before the data is used
+	void needArguments(){
+		if (lazyTypes != NULL){
+			decodeArguments();
+		}
+	}
     
 /*=============================================================================
     DECODING INCOMING BYTES
@@ -67,25 +194,28 @@ private:
         TYPES,
         TYPES_PADDING,
         DATA,
-        DATA_PADDING,
         DONE,
     } decodeState;
     
-    //stores incoming bytes until they can be decoded
-    uint8_t * incomingBuffer;
-    int incomingBufferSize; // how many bytes are stored
-    int incomingBufferFree; // how many bytes are allocated but unused
-    
-    //adds a byte to the buffer
-    void addToIncomingBuffer(uint8_t);
-    //clears the incoming buffer
-    void clearIncomingBuffer();
+    //the incoming bytes go straight into the address, type tags and data as they arrive
+    //the number of bytes of the field being decoded (address, type tags or datum) received so far
+    int decodeLength;
+    //the number of bytes the datum being decoded takes up with its padding, 0 until it's known
+    int decodeSize;
+    //the number of type tags received
+    //their data is decoded in order, so dataCount is the position being decoded
+    int decodeCount;
     
     //decoding function
     void decode(uint8_t);
-    void decodeAddress();
+    //decodes a whole message in one pass
+    //returns false if it has to be left to the byte-wise decoder
+    bool decodePacket(uint8_t *, int);
+    void decodeAddress(uint8_t);
     void decodeType(uint8_t);
     void decodeData(uint8_t);
+    //moves past the data which has no bytes, to the next one to be decoded
+    void nextDecodePosition();
 
 /*=============================================================================
 	HELPER FUNCTIONS
@@ -93,15 +223,59 @@ private:
 
 	void setupMessage();
 
-	//compares the OSCData's type char to a test char
+	//allocations go to the arena if the message has one, otherwise to the heap
+	void * allocate(void * ptr, int oldSize, int newSize);
+	void release(void * ptr);
+
+	//copies the address and the data of another message
+	void copy(const OSCMessage *);
+	//takes over another message's memory, leaving it without an address
+	//a StaticOSCMessage's storage can't be taken, so that one is copied
+	void take(OSCMessage &);
+	//gives back everything the message allocated
+	void releaseMessage();
+
+	//keeps the address, type tags and data in those buffers from now on
+	void useStorage(char * addressBuffer, int addressCapacity, char * typesBuffer, int typesCapacity, uint8_t * valuesBuffer, int valuesCapacity);
+
+	//make sure there is room for that many type tags / bytes of data / bytes of address
+	bool reserveTypes(int count);
+	bool reserveValues(int length);
+	bool reserveAddress(int length);
+
+	//makes room for a datum of that type and (padded) size at the position
+	//replacing the one which is there, or appending it at the end
+	//returns where its bytes go, NULL if it failed
+	uint8_t * place(int position, char type, int size);
+
+	//returns the offset of the datum in the values
+	//or -1 if the position is out of bounds
+	int valueOffset(int position);
+
+	//returns the datum's bytes if there is no error and it has that type
+	uint8_t * getValue(int position, char type);
+
+	//returns the contents of the string ('s') or blob ('b') at the position, stored or borrowed
+	//the length is the string's including the null, or the blob's without its size
+	const uint8_t * getBytes(int position, char type, int * length);
+
+	//stores a reference to the string or blob instead of its bytes
+	void setBorrowed(int position, char type, const uint8_t * data, int length);
+
+	//compares the datum's type char to a test char
 	bool testType(int position, char type);
 
-	//returns the number of bytes to pad to make it 4-bit aligned
-    //	int padSize(int bytes);
-    
+	//copy a run of 4-byte data of one type out of / into the message
+	int getWords(int position, char type, void * words, int n);
+	void addWords(char type, const void * words, int n);
+
+	//lays out the address, type tags, padding and arguments in one pass
+	void encode(OSCEncoder &);
+
 public:
 
-	//returns the OSCData at that position
+	//returns a copy of the datum at that position
+	//it belongs to the message and is only valid until the next call
 	OSCData * getOSCData(int);
 
 /*=============================================================================
@@ -118,6 +292,24 @@ public:
 	//OSCMessage(const char * _address, char * types, ... );
     //created from another OSCMessage
     OSCMessage (OSCMessage *);
+    //everything decoded into the message comes from the arena
+    //empty() resets the arena, which releases the address as well
+    OSCMessage (OSCArena &);
+
+    //copies the address and the data
+    OSCMessage (const OSCMessage &);
+    OSCMessage & operator=(const OSCMessage &);
+#if __cplusplus >= 201103L
+    //takes the address and the data without copying them
+    OSCMessage (OSCMessage &&);
+    OSCMessage & operator=(OSCMessage &&);
+#endif
+
+	//messages can be made in memory which is already allocated (like a bundle's arena)
+	static void * operator new(size_t size){ return malloc(size); }
+	static void * operator new(size_t, void * where){ return where; }
+	static void operator delete(void * ptr){ free(ptr); }
+	static void operator delete(void *, void *){ }
 
 	//DESTRUCTOR
 	~OSCMessage();
@@ -125,110 +317,54 @@ public:
 	//empties all of the data
 	void empty();
 
+	//makes room for that many arguments, 4 bytes each unless it's given the number of bytes
+	//from then on empty() keeps the room instead of freeing it
+	void reserve(int count, int bytes = -1);
+
 /*=============================================================================
 	SETTING  DATA
 =============================================================================*/
 
 	//returns the OSCMessage so that multiple 'add's can be strung together
-	template <typename T> 
-	OSCMessage& add(T datum){
-		//make a piece of data
-		OSCData * d = new OSCData(datum);
-		//check if it has any errors
-		if (d->error == ALLOCFAILED){
-			error = ALLOCFAILED;
-		} else {
-			//resize the data array
-			OSCData ** dataMem = (OSCData **) realloc(data, sizeof(OSCData *) * (dataCount + 1));
-			if (dataMem == NULL){
-				error = ALLOCFAILED;
-			} else {
-				data = dataMem;
-				//add data to the end of the array
-				data[dataCount] = d;
-				//increment the data size
-				dataCount++;
-			}
-		}
-		return *this;
-	}
+	OSCMessage& add(const char *);
+	OSCMessage& add(int);
+	OSCMessage& add(int32_t);
+	OSCMessage& add(float);
+	OSCMessage& add(double);
+	OSCMessage& add(bool);
+	OSCMessage& add(uint64_t);
     
     //blob specific add
-    OSCMessage& add(uint8_t * blob, int length){
-		//make a piece of data
-		OSCData * d = new OSCData(blob, length);
-		//check if it has any errors
-		if (d->error == ALLOCFAILED){
-			error = ALLOCFAILED;
-		} else {
-			//resize the data array
-			OSCData ** dataMem = (OSCData **) realloc(data, sizeof(OSCData *) * (dataCount + 1));
-			if (dataMem == NULL){
-				error = ALLOCFAILED;
-			} else {
-				data = dataMem;
-				//add data to the end of the array
-				data[dataCount] = d;
-				//increment the data size
-				dataCount++;
-			}
-		}
-		return *this;
-	}
+    OSCMessage& add(uint8_t * blob, int length);
+
+    //adds n floats / ints in one go
+    OSCMessage& addFloats(const float *, int n);
+    OSCMessage& addInts(const int32_t *, int n);
+
+    //adds a string / blob without copying it
+    //the caller's memory has to stay valid and unchanged until the message is sent
+    OSCMessage& addBorrowed(const char *);
+    OSCMessage& addBorrowed(const uint8_t * blob, int length);
 
 	//sets the data at a position
-	template <typename T> 
-	void set(int position, T datum){
-		if (position < dataCount){
-			//replace the OSCData with a new one
-			OSCData * oldDatum = getOSCData(position);
-			//destroy the old one
-			delete oldDatum;
-			//make a new one
-			OSCData * newDatum = new OSCData(datum);
-			//test if there was an error
-			if (newDatum->error == ALLOCFAILED){
-				error = ALLOCFAILED;
-			} else {
-				//otherwise, put it in the data array
-				data[position] = newDatum;
-			}
-		} else if (position == (dataCount)){
-			//add the data to the end
-			add(datum);
-		} else {
-			//else out of bounds error
-			error = INDEX_OUT_OF_BOUNDS;
-		}
-	}
+	//setting the position after the last datum adds it
+	void set(int position, const char *);
+	void set(int position, int);
+	void set(int position, int32_t);
+	void set(int position, float);
+	void set(int position, double);
+	void set(int position, bool);
+	void set(int position, uint64_t);
     
     //blob specific setter
-    void set(int position, uint8_t * blob, int length){
-        if (position < dataCount){
-			//replace the OSCData with a new one
-			OSCData * oldDatum = getOSCData(position);
-			//destroy the old one
-			delete oldDatum;
-			//make a new one
-			OSCData * newDatum = new OSCData(blob, length);
-			//test if there was an error
-			if (newDatum->error == ALLOCFAILED){
-				error = ALLOCFAILED;
-			} else {
-				//otherwise, put it in the data array
-				data[position] = newDatum;
-			}
-		} else if (position == (dataCount)){
-			//add the data to the end
-			add(blob, length);
-		} else {
-			//else out of bounds error
-			error = INDEX_OUT_OF_BOUNDS;
-		}
-    }
+    void set(int position, uint8_t * blob, int length);
     
     void setAddress(const char *);
 
+    //takes addresses from the table instead of copying them, NULL to go back to copying
+    //the table has to outlive the message
+    void setAddressTable(OSCAddressTable *);
+
 /*=============================================================================
 	GETTING DATA
 
@@ -242,14 +378,31 @@ public:
 	double getDouble(int);
     bool getBoolean(int);
 
+	//copies up to n floats / ints starting at the position
+	//stops at the first datum of another type, returns the number copied
+	int getFloats(int position, float *, int n);
+	int getInts(int position, int32_t *, int n);
+
 	//return the copied string's length
 	int getString(int, char *, int);
 	//returns the number of unsigned int8's copied into the buffer
 	int getBlob(int, uint8_t *, int);
 
+	//point at the string / blob contents instead of copying them
+	//valid until the message is changed or emptied, NULL if it's another type
+	const char * getStringPtr(int);
+	const uint8_t * getBlobPtr(int);
+	//the number of bytes in the blob (without its size)
+	int getBlobLength(int);
+
 	//returns the number of bytes of the data at that position
 	int getDataLength(int);
 
+	//fills in a struct with a field for each type tag (see oscDecodeStruct) if the
+	//message's type tags are exactly these, returns false and leaves it alone if not
+	//the strings point into the message, or into the packet with lazy decoding
+	bool getArguments(const char * types, void * target);
+
 	//returns the type at the position
 	char getType(int);
 
@@ -260,6 +413,13 @@ public:
     int getDataCount();
     int getAddressLength(int offset = 0);
 
+	//the hash of the address, the same as OSCAddressTable::hash
+	//worked out once and kept until the address changes
+	uint32_t getAddressHash();
+	//the table's copy of the address, NULL if it isn't interned
+	//two messages from the same table have the same address exactly when these are equal
+	const char * getInternedAddress();
+
 /*=============================================================================
 	TESTING DATA
 
@@ -293,6 +453,56 @@ public:
 	//the address match offset is sent as an argument to the callback
 	//also room for an option address offset to allow for multiple nested routes
 	bool route(const char * pattern, void (*callback)(OSCMessage &, int), int = 0);
+
+	//the same, with a pattern compiled ahead of time
+	bool fullMatch(const OSCPattern & pattern, int = 0);
+	int match(const OSCPattern & pattern, int = 0);
+	bool dispatch(const OSCPattern & pattern, void (*callback)(OSCMessage &), int = 0);
+	bool route(const OSCPattern & pattern, void (*callback)(OSCMessage &, int), int = 0);
+
+#if __cplusplus >= 201103L
+	//the same, but the callback can be anything which is called like the function:
+	//a lambda with captures, an object with operator(), or [&obj](OSCMessage & m){ obj.handle(m); }
+	//it's called in place, so the compiler can inline it, and nothing is allocated
+	//an object passed by name is called by reference and keeps its state
+	template <typename Callback>
+	bool dispatch(const char * pattern, Callback && callback, int addr_offset = 0){
+		if (!fullMatch(pattern, addr_offset)){
+			return false;
+		}
+		callback(*this);
+		return true;
+	}
+
+	template <typename Callback>
+	bool route(const char * pattern, Callback && callback, int initial_offset = 0){
+		int match_offset = match(pattern, initial_offset);
+		if (match_offset <= 0){
+			return false;
+		}
+		callback(*this, match_offset + initial_offset);
+		return true;
+	}
+
+	template <typename Callback>
+	bool dispatch(const OSCPattern & pattern, Callback && callback, int addr_offset = 0){
+		if (!fullMatch(pattern, addr_offset)){
+			return false;
+		}
+		callback(*this);
+		return true;
+	}
+
+	template <typename Callback>
+	bool route(const OSCPattern & pattern, Callback && callback, int initial_offset = 0){
+		int match_offset = match(pattern, initial_offset);
+		if (match_offset <= 0){
+			return false;
+		}
+		callback(*this, match_offset + initial_offset);
+		return true;
+	}
+#endif
 	
 
 
@@ -310,12 +520,41 @@ public:
     TRANSMISSION
  =============================================================================*/
     
-    //send the message
+    //send the message with a single write when it fits in OSC_SEND_BUFFER_SIZE
     void send(Print &p);
+
+    //encodes the message into the buffer
+    //returns the number of bytes the encoded message needs
+    //if that is more than the capacity nothing is written
+    size_t encode(uint8_t * buffer, size_t capacity);
     
     //fill the message from a byte stream
+    //each byte is written straight into the address, type tags or data, which are
+    //stored the way they're sent, so nothing is copied when a field ends
+    //with a StaticOSCMessage (or a bundle's reserveFixed) nothing is ever allocated and
+    //the work for each byte is bounded, so it can be called from an interrupt. a message
+    //which doesn't fit sets BUFFER_FULL. a filter is matched once the address is complete
     void fill(uint8_t);
+    //a complete message (e.g. a UDP packet) is decoded in a single pass
+    //anything else is passed through the byte-wise decoder
     void fill(uint8_t *, int);
+
+    //a packet passed to fill(uint8_t *, int) only has its address and type tags decoded
+    //the arguments are checked and copied out of the packet the first time one is read,
+    //so a message which is never matched costs nothing for them
+    //the packet has to stay put until then, or until decodeArguments() is called
+    //an argument which doesn't fit the packet shows up as INVALID_OSC when it's read
+    void setLazyDecoding(bool);
+
+    //a decoded message is only kept if its address matches one of the patterns
+    //(or starts with it, like route), otherwise it's turned away as soon as the address
+    //is complete: nothing after it is buffered or allocated, and the error is FILTERED
+    //the patterns aren't copied, NULL takes every message
+    void setFilter(const char * const * patterns, int count);
+
+    //copies arguments left in the packet by lazy decoding into the message
+    //returns false if they're invalid or don't fit
+    bool decodeArguments();
 		
 /*=============================================================================
 	ERROR
@@ -327,4 +566,49 @@ public:
 
 };
 
-#endif
\ No newline at end of file
+/*=============================================================================
+	STATIC MESSAGE
+
+	an OSCMessage which never allocates: the address (including its null),
+	up to MaxArgs type tags and MaxPayload bytes of encoded data are stored
+	inside the object, so it can be a global on boards without room for a heap.
+	adding past the limits sets BUFFER_FULL.
+
+	a byte stream is decoded straight into the same storage, see fill(uint8_t).
+
+	getOSCData is the one call which still allocates.
+=============================================================================*/
+
+template <int MaxArgs, int MaxAddr, int MaxPayload>
+class StaticOSCMessage : public OSCMessage
+{
+
+private:
+
+	char addressStorage[MaxAddr];
+	char typesStorage[MaxArgs > 0 ? MaxArgs : 1];
+	uint8_t valuesStorage[MaxPayload > 0 ? MaxPayload : 1];
+
+	void setupStorage(){
+		useStorage(addressStorage, MaxAddr, typesStorage, MaxArgs, valuesStorage, MaxPayload);
+	}
+
+	//the storage can't be shared, copy with OSCMessage(OSCMessage *) instead
+	StaticOSCMessage(const StaticOSCMessage &);
+	StaticOSCMessage & operator=(const StaticOSCMessage &);
+
+public:
+
+	StaticOSCMessage(const char * _address){
+		setupStorage();
+		error = OSC_OK;
+		setAddress(_address);
+	}
+
+	//no address, just like OSCMessage() it's invalid until one is set or filled
+	StaticOSCMessage(){
+		setupStorage();
+	}
+};
+
+#endif
@@ -0,0 +1,257 @@
+/*
+ The Center for New Music and Audio Technologies,
+ University of California, Berkeley.  Copyright (c) 2014, The Regents of
+ the University of California (Regents).
+ 
+ Permission to use, copy, modify, distribute, and distribute modified versions
+ of this software and its documentation without fee and without a signed
+ licensing agreement, is hereby granted, provided that the above copyright
+ notice, this paragraph and the following two paragraphs appear in all copies,
+ modifications, and distributions.
+ 
+ IN NO EVENT SHALL REGENTS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS, ARISING
+ OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF REGENTS HAS
+ BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE. THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED
+ HEREUNDER IS PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE
+ MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+
+#include "OSCMessageTemplate.h"
+
+/*=============================================================================
+	CONSTRUCTORS / DESTRUCTOR
+=============================================================================*/
+
+//the number of bytes of data for a type which fits in a fixed frame, -1 if it doesn't
+static int fixedSize(char type){
+	switch (type){
+		case 'i':
+		case 'f':
+		case 'c':
+		case 'r':
+		case 'm':
+			return 4;
+		case 'h':
+		case 't':
+			return 8;
+		case 'd':
+			//some 8-bit boards only have a 4-byte double, it can't fill an 8-byte slot
+			return sizeof(double) == 8 ? 8 : -1;
+		case 'T':
+		case 'F':
+		case 'N':
+		case 'I':
+			return 0;
+		default:
+			return -1;
+	}
+}
+
+OSCMessageTemplate::OSCMessageTemplate(const char * address, const char * _types){
+	frame = NULL;
+	frameSize = 0;
+	types = NULL;
+	dataCount = strlen(_types);
+	offsets = NULL;
+	error = OSC_OK;
+	//work out the layout first
+	int addrLen = strlen(address) + 1;
+	int addrSize = addrLen + padSize(addrLen);
+	int typesLen = dataCount + 2;
+	int typesSize = typesLen + padSize(typesLen);
+	int dataSize = 0;
+	for (int i = 0; i < dataCount; i++){
+		int argSize = fixedSize(_types[i]);
+		if (argSize < 0){
+			error = INVALID_OSC;
+			dataCount = 0;
+			return;
+		}
+		dataSize += argSize;
+	}
+	//the offsets go first in the allocation so they're aligned
+	int size = addrSize + typesSize + dataSize;
+	uint8_t * block = (uint8_t *) malloc(dataCount * sizeof(uint16_t) + size);
+	if (block == NULL){
+		error = ALLOCFAILED;
+		dataCount = 0;
+		return;
+	}
+	offsets = (uint16_t *) block;
+	frame = block + dataCount * sizeof(uint16_t);
+	frameSize = size;
+	//the address, the type tags and the data, all padded with zeros
+	memset(frame, 0, frameSize);
+	memcpy(frame, address, addrLen - 1);
+	types = (char *) frame + addrSize + 1;
+	types[-1] = ',';
+	memcpy(types, _types, dataCount);
+	int offset = addrSize + typesSize;
+	for (int i = 0; i < dataCount; i++){
+		offsets[i] = offset;
+		offset += fixedSize(_types[i]);
+	}
+}
+
+OSCMessageTemplate::~OSCMessageTemplate(){
+	//the offsets and the frame are one allocation
+	free(offsets);
+}
+
+/*=============================================================================
+	SETTING DATA
+=============================================================================*/
+
+uint8_t * OSCMessageTemplate::argument(int position, const char * accepted){
+	if (position < 0 || position >= dataCount){
+		error = INDEX_OUT_OF_BOUNDS;
+		return NULL;
+	}
+	if (strchr(accepted, types[position]) == NULL){
+		error = INVALID_OSC;
+		return NULL;
+	}
+	return frame + offsets[position];
+}
+
+OSCMessageTemplate & OSCMessageTemplate::set(int position, int value){
+	return set(position, (int32_t) value);
+}
+
+OSCMessageTemplate & OSCMessageTemplate::set(int position, int32_t value){
+	uint8_t * arg = argument(position, "icrm");
+	if (arg != NULL){
+		oscBigEndianCopy32(arg, &value, 1);
+	}
+	return *this;
+}
+
+OSCMessageTemplate & OSCMessageTemplate::set(int position, float value){
+	uint8_t * arg = argument(position, "f");
+	if (arg != NULL){
+		oscBigEndianCopy32(arg, &value, 1);
+	}
+	return *this;
+}
+
+OSCMessageTemplate & OSCMessageTemplate::set(int position, double value){
+	//if it's not 8 bytes it's not a true double, like OSCMessage::set
+	if (sizeof(double) != 8){
+		return set(position, (float) value);
+	}
+	uint8_t * arg = argument(position, "d");
+	if (arg != NULL){
+		value = BigEndian(value);
+		memcpy(arg, &value, sizeof(value));
+	}
+	return *this;
+}
+
+OSCMessageTemplate & OSCMessageTemplate::set(int position, int64_t value){
+	uint8_t * arg = argument(position, "h");
+	if (arg != NULL){
+		value = BigEndian(value);
+		memcpy(arg, &value, 8);
+	}
+	return *this;
+}
+
+OSCMessageTemplate & OSCMessageTemplate::set(int position, uint64_t value){
+	uint8_t * arg = argument(position, "t");
+	if (arg != NULL){
+		value = BigEndian(value);
+		memcpy(arg, &value, 8);
+	}
+	return *this;
+}
+
+OSCMessageTemplate & OSCMessageTemplate::set(int position, bool value){
+	if (position < 0 || position >= dataCount){
+		error = INDEX_OUT_OF_BOUNDS;
+	} else if (types[position] != 'T' && types[position] != 'F'){
+		error = INVALID_OSC;
+	} else {
+		//neither has any data, so only the type tag changes
+		types[position] = value ? 'T' : 'F';
+	}
+	return *this;
+}
+
+OSCMessageTemplate & OSCMessageTemplate::setFloats(int position, const float * f, int n){
+	if (n > 0 && argument(position, "f") != NULL){
+		//4-byte arguments follow each other in the frame
+		for (int i = 1; i < n; i++){
+			if (position + i >= dataCount || types[position + i] != 'f'){
+				error = position + i >= dataCount ? INDEX_OUT_OF_BOUNDS : INVALID_OSC;
+				return *this;
+			}
+		}
+		oscBigEndianCopy32(frame + offsets[position], f, n);
+	}
+	return *this;
+}
+
+OSCMessageTemplate & OSCMessageTemplate::setInts(int position, const int32_t * i, int n){
+	if (n > 0 && argument(position, "i") != NULL){
+		for (int j = 1; j < n; j++){
+			if (position + j >= dataCount || types[position + j] != 'i'){
+				error = position + j >= dataCount ? INDEX_OUT_OF_BOUNDS : INVALID_OSC;
+				return *this;
+			}
+		}
+		oscBigEndianCopy32(frame + offsets[position], i, n);
+	}
+	return *this;
+}
+
+/*=============================================================================
+	SENDING
+=============================================================================*/
+
+void OSCMessageTemplate::send(Print &p){
+	//a set() which failed left the frame as it was, only a missing frame stops it
+	if (frame == NULL){
+		return;
+	}
+	p.write(frame, frameSize);
+}
+
+size_t OSCMessageTemplate::encode(uint8_t * buffer, size_t capacity){
+	if (frame == NULL){
+		return 0;
+	}
+	if ((size_t) frameSize <= capacity){
+		memcpy(buffer, frame, frameSize);
+	}
+	return frameSize;
+}
+
+const uint8_t * OSCMessageTemplate::getFrame(){
+	return frame;
+}
+
+int OSCMessageTemplate::bytes(){
+	return frameSize;
+}
+
+int OSCMessageTemplate::size(){
+	return dataCount;
+}
+
+/*=============================================================================
+	ERROR HANDLING
+=============================================================================*/
+
+bool OSCMessageTemplate::hasError(){
+	return error != OSC_OK;
+}
+
+OSCErrorCode OSCMessageTemplate::getError(){
+	return error;
+}
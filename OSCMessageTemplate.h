@@ -0,0 +1,134 @@
+/*
+ The Center for New Music and Audio Technologies,
+ University of California, Berkeley.  Copyright (c) 2014, The Regents of
+ the University of California (Regents).
+ 
+ Permission to use, copy, modify, distribute, and distribute modified versions
+ of this software and its documentation without fee and without a signed
+ licensing agreement, is hereby granted, provided that the above copyright
+ notice, this paragraph and the following two paragraphs appear in all copies,
+ modifications, and distributions.
+ 
+ IN NO EVENT SHALL REGENTS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS, ARISING
+ OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF REGENTS HAS
+ BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE. THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED
+ HEREUNDER IS PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE
+ MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+
+#ifndef OSCMESSAGETEMPLATE_h
+#define OSCMESSAGETEMPLATE_h
+
+#include "OSCData.h"
+
+/*
+ a message which is sent over and over with the same address and type tags
+
+ the address, type tags and padding are encoded once into a frame, along
+ with where each argument starts. set() writes an argument's bytes in place,
+ so sending is one write of a buffer which is already laid out.
+
+ the arguments have to have a fixed size: 'i' 'f' 'c' 'r' 'm' 'h' 't' 'd',
+ and 'T' 'F' 'N' 'I' which take up no data. they start out as 0 (or false).
+ where a double only has 4 bytes 'd' can't be used, use 'f' instead.
+ the frame is allocated by the constructor and never again.
+ */
+
+class OSCMessageTemplate
+{
+
+private:
+
+/*=============================================================================
+	PRIVATE VARIABLES
+=============================================================================*/
+
+	//the encoded message
+	uint8_t * frame;
+	int frameSize;
+
+	//the type tags inside the frame
+	char * types;
+	int dataCount;
+
+	//where each argument starts in the frame
+	uint16_t * offsets;
+
+	//error codes for potential runtime problems
+	OSCErrorCode error;
+
+	//returns where the argument starts if it has one of the accepted types, NULL if not
+	uint8_t * argument(int position, const char * accepted);
+
+	//not copyable, the frame belongs to one template
+	OSCMessageTemplate(const OSCMessageTemplate &);
+	OSCMessageTemplate & operator=(const OSCMessageTemplate &);
+
+public:
+
+/*=============================================================================
+	CONSTRUCTORS / DESTRUCTOR
+=============================================================================*/
+
+	//a type which can't go in a fixed frame sets INVALID_OSC
+	OSCMessageTemplate(const char * address, const char * types);
+
+	~OSCMessageTemplate();
+
+/*=============================================================================
+	SETTING DATA
+
+	the value has to match the type tag at the position ('c' 'r' 'm' take an int),
+	otherwise nothing is written and the error is set.
+	the frame can still be sent, it keeps the value from before
+=============================================================================*/
+
+	OSCMessageTemplate & set(int position, int value);
+	OSCMessageTemplate & set(int position, int32_t value);
+	OSCMessageTemplate & set(int position, float value);
+	OSCMessageTemplate & set(int position, double value);
+	OSCMessageTemplate & set(int position, int64_t value);
+	OSCMessageTemplate & set(int position, uint64_t value);
+	//switches the type tag between 'T' and 'F'
+	OSCMessageTemplate & set(int position, bool value);
+
+	//overwrites n floats / ints starting at the position, in one go
+	OSCMessageTemplate & setFloats(int position, const float *, int n);
+	OSCMessageTemplate & setInts(int position, const int32_t *, int n);
+
+/*=============================================================================
+	SENDING
+=============================================================================*/
+
+	//writes the frame to the Print
+	void send(Print &p);
+
+	//copies the frame into the buffer if it fits
+	//returns the number of bytes the message needs either way
+	size_t encode(uint8_t * buffer, size_t capacity);
+
+	//the frame itself, bytes() long
+	const uint8_t * getFrame();
+
+	//the number of bytes the message occupies when encoded
+	int bytes();
+
+	int size();
+
+/*=============================================================================
+	ERROR
+=============================================================================*/
+
+	bool hasError();
+
+	OSCErrorCode getError();
+
+};
+
+#endif
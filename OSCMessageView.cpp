@@ -0,0 +1,445 @@
+/*
+ The Center for New Music and Audio Technologies,
+ University of California, Berkeley.  Copyright (c) 2014, The Regents of
+ the University of California (Regents).
+ 
+ Permission to use, copy, modify, distribute, and distribute modified versions
+ of this software and its documentation without fee and without a signed
+ licensing agreement, is hereby granted, provided that the above copyright
+ notice, this paragraph and the following two paragraphs appear in all copies,
+ modifications, and distributions.
+ 
+ IN NO EVENT SHALL REGENTS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS, ARISING
+ OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF REGENTS HAS
+ BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE. THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED
+ HEREUNDER IS PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE
+ MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+#include "OSCMessageView.h"
+#include "OSCMatch.h"
+
+/*=============================================================================
+	CONSTRUCTORS
+=============================================================================*/
+
+OSCMessageView::OSCMessageView(const uint8_t * buffer, int length){
+	packet = buffer;
+	packetSize = length;
+	address = NULL;
+	types = NULL;
+	arguments = NULL;
+	dataCount = 0;
+	error = OSC_OK;
+	validate(true);
+}
+
+OSCMessageView::OSCMessageView(const uint8_t * buffer, int length, bool checkArguments){
+	packet = buffer;
+	packetSize = length;
+	address = NULL;
+	types = NULL;
+	arguments = NULL;
+	dataCount = 0;
+	error = OSC_OK;
+	validate(checkArguments);
+}
+
+/*=============================================================================
+	VALIDATION
+=============================================================================*/
+
+void OSCMessageView::validate(bool checkArguments){
+	//an OSC message is 4-byte aligned and starts with an address
+	if (packet == NULL || packetSize < 4 || (packetSize & 3) != 0 || packet[0] != '/'){
+		error = INVALID_OSC;
+		return;
+	}
+	const uint8_t * end = packet + packetSize;
+	//the address
+	const uint8_t * ptr = (const uint8_t *) memchr(packet, 0, packetSize);
+	if (ptr == NULL){
+		error = INVALID_OSC;
+		return;
+	}
+	int addrLen = ptr - packet + 1;
+	ptr = packet + addrLen + padSize(addrLen);
+	//the type tags
+	if (ptr >= end || *ptr != ','){
+		error = INVALID_OSC;
+		return;
+	}
+	const uint8_t * typesEnd = (const uint8_t *) memchr(ptr, 0, end - ptr);
+	if (typesEnd == NULL){
+		error = INVALID_OSC;
+		return;
+	}
+	int typesLen = typesEnd - ptr + 1;
+	const char * typeTags = (const char *) ptr + 1;
+	int typeCount = typesLen - 2;
+	ptr += typesLen + padSize(typesLen);
+	const uint8_t * firstArgument = ptr;
+	if (ptr > end){
+		error = INVALID_OSC;
+		return;
+	}
+	//each of the arguments has to fit in what's left of the packet
+	for (int i = 0; checkArguments && i < typeCount; i++){
+		int argSize = oscArgumentSize(typeTags[i], ptr, end - ptr);
+		if (argSize < 0){
+			error = INVALID_OSC;
+			return;
+		}
+		ptr += argSize;
+	}
+	//and nothing can be left over
+	if (checkArguments && ptr != end){
+		error = INVALID_OSC;
+		return;
+	}
+	address = (const char *) packet;
+	types = typeTags;
+	dataCount = typeCount;
+	arguments = firstArgument;
+	cursorPosition = 0;
+	cursor = arguments;
+}
+
+/*=============================================================================
+	GETTING DATA
+=============================================================================*/
+
+const uint8_t * OSCMessageView::getArgument(int position){
+	if (types == NULL || position < 0 || position >= dataCount){
+		error = INDEX_OUT_OF_BOUNDS;
+		return NULL;
+	}
+	//start over if the position is behind the cursor
+	if (position < cursorPosition){
+		cursorPosition = 0;
+		cursor = arguments;
+	}
+	//the packet was validated so the sizes can't run past the end
+	while (cursorPosition < position){
+		cursor += oscArgumentSize(types[cursorPosition], cursor, packet + packetSize - cursor);
+		cursorPosition++;
+	}
+	return cursor;
+}
+
+int32_t OSCMessageView::getInt(int position){
+	const uint8_t * arg = getArgument(position);
+	if (arg != NULL && types[position] == 'i'){
+		union {
+			int32_t i;
+			uint8_t b[4];
+		} u;
+		memcpy(u.b, arg, 4);
+		return BigEndian(u.i);
+	} else {
+		return 0;
+	}
+}
+
+uint64_t OSCMessageView::getTime(int position){
+	const uint8_t * arg = getArgument(position);
+	if (arg != NULL && types[position] == 't'){
+		union {
+			uint64_t t;
+			uint8_t b[8];
+		} u;
+		memcpy(u.b, arg, 8);
+		return BigEndian(u.t);
+	} else {
+		return 0;
+	}
+}
+
+float OSCMessageView::getFloat(int position){
+	const uint8_t * arg = getArgument(position);
+	if (arg != NULL && types[position] == 'f'){
+		union {
+			float f;
+			uint8_t b[4];
+		} u;
+		memcpy(u.b, arg, 4);
+		return BigEndian(u.f);
+	} else {
+		return 0;
+	}
+}
+
+double OSCMessageView::getDouble(int position){
+	const uint8_t * arg = getArgument(position);
+	if (arg != NULL && types[position] == 'd'){
+		union {
+			double d;
+			uint8_t b[8];
+		} u;
+		memcpy(u.b, arg, 8);
+		return BigEndian(u.d);
+	} else {
+		return 0;
+	}
+}
+
+bool OSCMessageView::getBoolean(int position){
+	return getArgument(position) != NULL && types[position] == 'T';
+}
+
+int OSCMessageView::getWords(int position, char type, void * words, int n){
+	const uint8_t * arg = getArgument(position);
+	if (arg == NULL || types[position] != type){
+		return 0;
+	}
+	//the run ends at the first argument of another type
+	int count = 1;
+	while (count < n && position + count < dataCount && types[position + count] == type){
+		count++;
+	}
+	oscBigEndianCopy32(words, arg, count);
+	//the next read carries on after the run
+	cursorPosition = position + count;
+	cursor = arg + count * 4;
+	return count;
+}
+
+int OSCMessageView::getFloats(int position, float * f, int n){
+	return n > 0 ? getWords(position, 'f', f, n) : 0;
+}
+
+int OSCMessageView::getInts(int position, int32_t * i, int n){
+	return n > 0 ? getWords(position, 'i', i, n) : 0;
+}
+
+int OSCMessageView::getString(int position, char * buffer, int bufferSize){
+	const char * str = getStringPtr(position);
+	if (str != NULL){
+		int strSize = strlen(str) + 1;
+		if (strSize <= bufferSize){
+			memcpy(buffer, str, strSize);
+			return strSize;
+		}
+	}
+	return 0;
+}
+
+int OSCMessageView::getBlob(int position, uint8_t * buffer, int bufferSize){
+	//same layout as OSCMessage::getBlob, the size followed by the contents
+	const uint8_t * arg = getArgument(position);
+	if (arg != NULL && types[position] == 'b'){
+		int blobSize = getBlobLength(position) + 4;
+		if (blobSize <= bufferSize){
+			memcpy(buffer, arg, blobSize);
+			return blobSize;
+		}
+	}
+	return 0;
+}
+
+const char * OSCMessageView::getStringPtr(int position){
+	const uint8_t * arg = getArgument(position);
+	if (arg != NULL && types[position] == 's'){
+		return (const char *) arg;
+	} else {
+		return NULL;
+	}
+}
+
+const uint8_t * OSCMessageView::getBlobPtr(int position){
+	const uint8_t * arg = getArgument(position);
+	if (arg != NULL && types[position] == 'b'){
+		return arg + 4;
+	} else {
+		return NULL;
+	}
+}
+
+int OSCMessageView::getBlobLength(int position){
+	const uint8_t * arg = getArgument(position);
+	if (arg != NULL && types[position] == 'b'){
+		union {
+			uint32_t i;
+			uint8_t b[4];
+		} u;
+		memcpy(u.b, arg, 4);
+		return BigEndian(u.i);
+	} else {
+		return 0;
+	}
+}
+
+int OSCMessageView::getDataLength(int position){
+	const uint8_t * arg = getArgument(position);
+	if (arg == NULL){
+		return 0;
+	}
+	//same as OSCData::bytes, without the padding
+	switch (types[position]){
+		case 's':
+			return strlen((const char *) arg) + 1;
+		case 'b':
+			return getBlobLength(position) + 4;
+		default:
+			return oscArgumentSize(types[position], arg, packet + packetSize - arg);
+	}
+}
+
+bool OSCMessageView::getArguments(const char * _types, void * target){
+	if (types == NULL || strcmp(types, _types) != 0){
+		return false;
+	}
+	return oscDecodeStruct(_types, arguments, packet + packetSize - arguments, target);
+}
+
+char OSCMessageView::getType(int position){
+	if (getArgument(position) != NULL){
+		return types[position];
+	} else {
+		return 0;
+	}
+}
+
+int OSCMessageView::getAddress(char * buffer, int offset){
+	if (address == NULL){
+		buffer[0] = '\0';
+		return 0;
+	}
+	strcpy(buffer, address + offset);
+	return strlen(buffer);
+}
+
+const char * OSCMessageView::getAddress(){
+	return address;
+}
+
+int OSCMessageView::getDataCount(){
+	return dataCount;
+}
+
+int OSCMessageView::getAddressLength(int offset){
+	if (address && offset < (int) strlen(address)){
+		return strlen(address + offset);
+	} else {
+		return 0;
+	}
+}
+
+/*=============================================================================
+	TESTING DATA
+=============================================================================*/
+
+bool OSCMessageView::testType(int position, char type){
+	return getArgument(position) != NULL && types[position] == type;
+}
+
+bool OSCMessageView::isInt(int position){
+	return testType(position, 'i');
+}
+
+bool OSCMessageView::isTime(int position){
+	return testType(position, 't');
+}
+
+bool OSCMessageView::isFloat(int position){
+	return testType(position, 'f');
+}
+
+bool OSCMessageView::isBlob(int position){
+	return testType(position, 'b');
+}
+
+bool OSCMessageView::isChar(int position){
+	return testType(position, 'c');
+}
+
+bool OSCMessageView::isString(int position){
+	return testType(position, 's');
+}
+
+bool OSCMessageView::isDouble(int position){
+	return testType(position, 'd');
+}
+
+bool OSCMessageView::isBoolean(int position){
+	return testType(position, 'T') || testType(position, 'F');
+}
+
+/*=============================================================================
+	PATTERN MATCHING
+=============================================================================*/
+
+int OSCMessageView::match(const char * pattern, int addr_offset){
+	if (address == NULL){
+		return 0;
+	}
+	int pattern_offset;
+	int address_offset;
+	int ret = osc_match(address + addr_offset, pattern, &pattern_offset, &address_offset);
+	const char * next = address + addr_offset + pattern_offset;
+	if (ret==3){
+		return pattern_offset;
+	} else if (pattern_offset > 0 && *next == '/'){
+		return pattern_offset;
+	} else {
+		return 0;
+	}
+}
+
+bool OSCMessageView::fullMatch(const char * pattern, int addr_offset){
+	if (address == NULL){
+		return false;
+	}
+	int pattern_offset;
+	int address_offset;
+	int ret = osc_match(address + addr_offset, pattern, &address_offset, &pattern_offset);
+	return (ret==3);
+}
+
+bool OSCMessageView::dispatch(const char * pattern, void (*callback)(OSCMessageView &), int addr_offset){
+	if (fullMatch(pattern, addr_offset)){
+		callback(*this);
+		return true;
+	} else {
+		return false;
+	}
+}
+
+bool OSCMessageView::route(const char * pattern, void (*callback)(OSCMessageView &, int), int initial_offset){
+	int match_offset = match(pattern, initial_offset);
+	if (match_offset>0){
+		callback(*this, match_offset + initial_offset);
+		return true;
+	} else {
+		return false;
+	}
+}
+
+/*=============================================================================
+	SIZE
+=============================================================================*/
+
+int OSCMessageView::size(){
+	return dataCount;
+}
+
+int OSCMessageView::bytes(){
+	return error == INVALID_OSC ? 0 : packetSize;
+}
+
+/*=============================================================================
+	ERROR HANDLING
+=============================================================================*/
+
+bool OSCMessageView::hasError(){
+	return error != OSC_OK;
+}
+
+OSCErrorCode OSCMessageView::getError(){
+	return error;
+}
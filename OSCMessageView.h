@@ -0,0 +1,202 @@
+/*
+ The Center for New Music and Audio Technologies,
+ University of California, Berkeley.  Copyright (c) 2014, The Regents of
+ the University of California (Regents).
+ 
+ Permission to use, copy, modify, distribute, and distribute modified versions
+ of this software and its documentation without fee and without a signed
+ licensing agreement, is hereby granted, provided that the above copyright
+ notice, this paragraph and the following two paragraphs appear in all copies,
+ modifications, and distributions.
+ 
+ IN NO EVENT SHALL REGENTS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS, ARISING
+ OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF REGENTS HAS
+ BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE. THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED
+ HEREUNDER IS PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE
+ MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+#ifndef OSCMESSAGEVIEW_h
+#define OSCMESSAGEVIEW_h
+
+#include "OSCData.h"
+
+/*
+ a read-only OSCMessage over a packet that is already in memory
+ (e.g. the buffer filled by Udp.read)
+
+ the packet is validated once when the view is made, after that
+ every getter points straight into it, nothing is copied or allocated.
+ the packet has to outlive the view.
+ */
+
+class OSCMessageView
+{
+
+private:
+
+	//friends
+	friend class OSCMessage;
+
+/*=============================================================================
+	PRIVATE VARIABLES
+=============================================================================*/
+
+	//the packet
+	const uint8_t * packet;
+	int packetSize;
+
+	//the address and the type tags (after the comma) inside the packet
+	const char * address;
+	const char * types;
+
+	//the number of arguments
+	int dataCount;
+
+	//the first argument inside the packet
+	const uint8_t * arguments;
+
+	//error codes for potential runtime problems
+	OSCErrorCode error;
+
+	//the last argument looked up, so walking the arguments in order stays linear
+	int cursorPosition;
+	const uint8_t * cursor;
+
+/*=============================================================================
+	HELPER FUNCTIONS
+=============================================================================*/
+
+	//checks the layout of the packet and sets up the pointers into it
+	//without the arguments, only the address and type tags are checked
+	void validate(bool checkArguments);
+
+	//for OSCMessage's lazy decoding, which checks the arguments when they're read
+	OSCMessageView(const uint8_t * buffer, int length, bool checkArguments);
+
+	//returns a pointer to the argument at that position inside the packet
+	const uint8_t * getArgument(int position);
+
+	//compares the argument's type char to a test char
+	bool testType(int position, char type);
+
+	//copies a run of 4-byte arguments of one type out of the packet
+	int getWords(int position, char type, void * words, int n);
+
+public:
+
+/*=============================================================================
+	CONSTRUCTORS
+=============================================================================*/
+
+	//the view points into the buffer, it does not copy it
+	OSCMessageView(const uint8_t * buffer, int length);
+
+/*=============================================================================
+	GETTING DATA
+
+	getters take a position as an argument
+=============================================================================*/
+
+	int32_t getInt(int);
+	uint64_t getTime(int);
+
+	float getFloat(int);
+	double getDouble(int);
+	bool getBoolean(int);
+
+	//copies up to n floats / ints starting at the position
+	//stops at the first argument of another type, returns the number copied
+	int getFloats(int position, float *, int n);
+	int getInts(int position, int32_t *, int n);
+
+	//return the copied string's length
+	int getString(int, char *, int);
+	//returns the number of unsigned int8's copied into the buffer
+	int getBlob(int, uint8_t *, int);
+
+	//point into the packet instead of copying
+	//the string is null terminated
+	const char * getStringPtr(int);
+	//points at the blob's contents, after its size
+	const uint8_t * getBlobPtr(int);
+	//the number of bytes in the blob's contents
+	int getBlobLength(int);
+
+	//returns the number of bytes of the data at that position
+	int getDataLength(int);
+
+	//fills in a struct with a field for each type tag (see oscDecodeStruct) if the
+	//message's type tags are exactly these, returns false and leaves it alone if not
+	bool getArguments(const char * types, void * target);
+
+	//returns the type at the position
+	char getType(int);
+
+	//put the address in the buffer
+	int getAddress(char * buffer, int offset = 0);
+	//points at the address inside the packet
+	const char * getAddress();
+
+	int getDataCount();
+	int getAddressLength(int offset = 0);
+
+/*=============================================================================
+	TESTING DATA
+
+	testers take a position as an argument
+=============================================================================*/
+
+	bool isInt(int);
+	bool isFloat(int);
+	bool isBlob(int);
+	bool isChar(int);
+	bool isString(int);
+	bool isDouble(int);
+	bool isBoolean(int);
+	bool isTime(int);
+
+/*=============================================================================
+	PATTERN MATCHING
+=============================================================================*/
+
+	//match the pattern against the address
+	//returns true only for a complete match
+	bool fullMatch(const char * pattern, int = 0);
+
+	//returns the number of characters matched in the address
+	int match(const char * pattern, int = 0);
+
+	//calls the function with the view as the arg if it was a full match
+	bool dispatch(const char * pattern, void (*callback)(OSCMessageView &), int = 0);
+
+	//like dispatch, but allows for partial matches
+	//the address match offset is sent as an argument to the callback
+	bool route(const char * pattern, void (*callback)(OSCMessageView &, int), int = 0);
+
+/*=============================================================================
+	SIZE
+=============================================================================*/
+
+	//the number of data that the message contains
+	int size();
+
+	//the number of bytes the message occupies in the packet
+	int bytes();
+
+/*=============================================================================
+	ERROR
+=============================================================================*/
+
+	bool hasError();
+
+	OSCErrorCode getError();
+
+};
+
+#endif
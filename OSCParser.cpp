@@ -0,0 +1,451 @@
+/*
+ The Center for New Music and Audio Technologies,
+ University of California, Berkeley.  Copyright (c) 2014, The Regents of
+ the University of California (Regents).
+ 
+ Permission to use, copy, modify, distribute, and distribute modified versions
+ of this software and its documentation without fee and without a signed
+ licensing agreement, is hereby granted, provided that the above copyright
+ notice, this paragraph and the following two paragraphs appear in all copies,
+ modifications, and distributions.
+ 
+ IN NO EVENT SHALL REGENTS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS, ARISING
+ OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF REGENTS HAS
+ BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE. THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED
+ HEREUNDER IS PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE
+ MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+
+#include "OSCParser.h"
+
+//the packet's own bundle (or message) has no end until endPacket
+#define NO_END 0xFFFFFFFF
+
+/*=============================================================================
+	CONSTRUCTORS / DESTRUCTOR
+=============================================================================*/
+
+OSCParser::OSCParser(){
+	reset();
+}
+
+OSCParser::~OSCParser(){
+}
+
+void OSCParser::reset(){
+	decodeState = STANDBY;
+	address[0] = '\0';
+	addressLength = 0;
+	types[0] = '\0';
+	typesLength = 0;
+	position = 0;
+	incomingBufferSize = 0;
+	argumentSize = 0;
+	chunkLength = 0;
+	dataRemaining = 0;
+	fieldLength = 0;
+	paddingLeft = 0;
+	received = 0;
+	elementEnd = NO_END;
+	depth = 0;
+	error = OSC_OK;
+}
+
+/*=============================================================================
+	FILLING
+=============================================================================*/
+
+void OSCParser::fill(uint8_t incomingByte){
+	decode(incomingByte);
+}
+
+void OSCParser::fill(const uint8_t * incomingBytes, int length){
+	int i = 0;
+	while (i < length){
+		//the middle of a string or blob is handed on straight from the bytes
+		if (decodeState == DATA && chunkLength == 0 && error == OSC_OK){
+			i += decodeData(incomingBytes + i, length - i);
+		} else {
+			decode(incomingBytes[i++]);
+		}
+	}
+}
+
+bool OSCParser::endPacket(){
+	bool complete;
+	if (error != OSC_OK){
+		complete = false;
+	} else if (decodeState == DONE || (decodeState == STANDBY && received == 0)){
+		complete = true;
+	} else if (decodeState == ELEMENT_SIZE && incomingBufferSize == 0 && depth == 1){
+		//between the elements of the packet's bundle
+		bundleEnd();
+		complete = true;
+	} else {
+		//cut short
+		complete = false;
+	}
+	reset();
+	return complete;
+}
+
+/*=============================================================================
+	DECODING
+=============================================================================*/
+
+void OSCParser::decode(uint8_t incomingByte){
+	if (error != OSC_OK){
+		return;
+	}
+	received++;
+	//an element can't run past the size its bundle gave it
+	if (received > elementEnd){
+		error = INVALID_OSC;
+		return;
+	}
+	switch (decodeState){
+		case STANDBY:
+			//the start of the packet or of an element in a bundle
+			if (incomingByte == '#'){
+				incomingBuffer[0] = incomingByte;
+				incomingBufferSize = 1;
+				decodeState = HEADER;
+			} else if (incomingByte == '/'){
+				address[0] = incomingByte;
+				addressLength = 1;
+				typesLength = 0;
+				decodeState = ADDRESS;
+			} else {
+				error = INVALID_OSC;
+			}
+			break;
+		case HEADER:
+			incomingBuffer[incomingBufferSize++] = incomingByte;
+			if (incomingBufferSize == 8){
+				if (memcmp(incomingBuffer, "#bundle", 8) != 0){
+					error = INVALID_OSC;
+				}
+				incomingBufferSize = 0;
+				decodeState = TIMETAG;
+			}
+			break;
+		case TIMETAG:
+			incomingBuffer[incomingBufferSize++] = incomingByte;
+			if (incomingBufferSize == 8){
+				decodeTimetag();
+			}
+			break;
+		case ELEMENT_SIZE:
+			incomingBuffer[incomingBufferSize++] = incomingByte;
+			if (incomingBufferSize == 4){
+				decodeElementSize();
+			}
+			break;
+		case ADDRESS:
+			if (incomingByte == '\0'){
+				address[addressLength] = '\0';
+				paddingLeft = padSize(addressLength + 1);
+				fieldLength = 0;
+				decodeState = paddingLeft > 0 ? ADDRESS_PADDING : TYPES;
+			} else if (addressLength + 1 < OSC_PARSER_MAX_ADDRESS){
+				address[addressLength++] = incomingByte;
+			} else {
+				error = BUFFER_FULL;
+			}
+			break;
+		case ADDRESS_PADDING:
+			if (--paddingLeft == 0){
+				decodeState = TYPES;
+			}
+			break;
+		case TYPES:
+			fieldLength++;
+			if (fieldLength == 1){
+				if (incomingByte != ','){
+					error = INVALID_OSC;
+				}
+			} else if (incomingByte == '\0'){
+				types[typesLength] = '\0';
+				paddingLeft = padSize(fieldLength);
+				if (paddingLeft > 0){
+					decodeState = TYPES_PADDING;
+				} else {
+					messageBegin(address, types);
+					position = 0;
+					nextArgument();
+				}
+			} else if (typesLength < OSC_PARSER_MAX_TYPES){
+				types[typesLength++] = incomingByte;
+			} else {
+				error = BUFFER_FULL;
+			}
+			break;
+		case TYPES_PADDING:
+			if (--paddingLeft == 0){
+				messageBegin(address, types);
+				position = 0;
+				nextArgument();
+			}
+			break;
+		case ARGUMENT:
+			incomingBuffer[incomingBufferSize++] = incomingByte;
+			if (incomingBufferSize == argumentSize){
+				argument(position, types[position]);
+				position++;
+				nextArgument();
+			}
+			break;
+		case BLOB_SIZE:
+			incomingBuffer[incomingBufferSize++] = incomingByte;
+			if (incomingBufferSize == 4){
+				memcpy(&dataRemaining, incomingBuffer, 4);
+				dataRemaining = BigEndian(dataRemaining);
+				fieldLength = dataRemaining;
+				chunkLength = 0;
+				decodeState = DATA;
+				if (dataRemaining == 0){
+					flushChunk(true);
+					endData();
+				}
+			}
+			break;
+		case DATA:
+			if (types[position] == 'b'){
+				chunk[chunkLength++] = incomingByte;
+				if (--dataRemaining == 0){
+					flushChunk(true);
+					endData();
+				} else if (chunkLength == OSC_PARSER_CHUNK_SIZE){
+					flushChunk(false);
+				}
+			} else {
+				fieldLength++;
+				if (incomingByte == '\0'){
+					flushChunk(true);
+					endData();
+				} else {
+					chunk[chunkLength++] = incomingByte;
+					if (chunkLength == OSC_PARSER_CHUNK_SIZE){
+						flushChunk(false);
+					}
+				}
+			}
+			break;
+		case DATA_PADDING:
+			if (--paddingLeft == 0){
+				position++;
+				nextArgument();
+			}
+			break;
+		case DONE:
+			//there's nothing after a message which isn't in a bundle
+			error = INVALID_OSC;
+			break;
+	}
+}
+
+void OSCParser::decodeTimetag(){
+	if (depth == OSC_PARSER_MAX_DEPTH){
+		error = BUFFER_FULL;
+		return;
+	}
+	uint64_t timetag;
+	memcpy(&timetag, incomingBuffer, 8);
+	timetag = BigEndian(timetag);
+	//the packet's own bundle ends with the packet, the others where their size says
+	bundleEnds[depth++] = elementEnd;
+	incomingBufferSize = 0;
+	decodeState = ELEMENT_SIZE;
+	bundleBegin(timetag);
+	//an empty bundle inside another one is already over
+	if (received == elementEnd){
+		endElement();
+	}
+}
+
+void OSCParser::decodeElementSize(){
+	int32_t elementSize;
+	memcpy(&elementSize, incomingBuffer, 4);
+	elementSize = BigEndian(elementSize);
+	incomingBufferSize = 0;
+	uint32_t bundleEnd = bundleEnds[depth - 1];
+	if (elementSize <= 0 || (elementSize & 3) != 0 || (bundleEnd != NO_END && received + elementSize > bundleEnd)){
+		error = INVALID_OSC;
+		return;
+	}
+	elementEnd = received + elementSize;
+	decodeState = STANDBY;
+}
+
+void OSCParser::nextArgument(){
+	incomingBufferSize = 0;
+	for (; position < typesLength; position++){
+		char type = types[position];
+		switch (type){
+			case 'i':
+			case 'f':
+			case 'c':
+			case 'r':
+			case 'm':
+				argumentSize = 4;
+				decodeState = ARGUMENT;
+				return;
+			case 'h':
+			case 't':
+			case 'd':
+				argumentSize = 8;
+				decodeState = ARGUMENT;
+				return;
+			case 's':
+			case 'S':
+				fieldLength = 0;
+				chunkLength = 0;
+				decodeState = DATA;
+				return;
+			case 'b':
+				decodeState = BLOB_SIZE;
+				return;
+			case 'T':
+			case 'F':
+			case 'N':
+			case 'I':
+				//no bytes to wait for
+				argument(position, type);
+				break;
+			default:
+				error = INVALID_OSC;
+				return;
+		}
+	}
+	endMessage();
+}
+
+void OSCParser::flushChunk(bool last){
+	argumentData(position, types[position], chunk, chunkLength, last);
+	chunkLength = 0;
+}
+
+void OSCParser::endData(){
+	paddingLeft = padSize(fieldLength);
+	if (paddingLeft > 0){
+		decodeState = DATA_PADDING;
+	} else {
+		position++;
+		nextArgument();
+	}
+}
+
+void OSCParser::endMessage(){
+	messageEnd();
+	if (depth == 0){
+		//a message on its own is the whole packet
+		decodeState = DONE;
+	} else {
+		endElement();
+	}
+}
+
+void OSCParser::endElement(){
+	//the element has to fill the size it was given
+	if (received != elementEnd){
+		error = INVALID_OSC;
+		return;
+	}
+	//the bundles which end with it
+	while (depth > 1 && received == bundleEnds[depth - 1]){
+		depth--;
+		bundleEnd();
+	}
+	//the next element's size belongs to the bundle it's in
+	elementEnd = bundleEnds[depth - 1];
+	incomingBufferSize = 0;
+	decodeState = ELEMENT_SIZE;
+}
+
+int OSCParser::decodeData(const uint8_t * bytes, int length){
+	char type = types[position];
+	int run;
+	bool last;
+	int used;
+	if (type == 'b'){
+		run = dataRemaining < (uint32_t) length ? dataRemaining : length;
+		last = (uint32_t) run == dataRemaining;
+		dataRemaining -= run;
+		used = run;
+	} else {
+		const uint8_t * end = (const uint8_t *) memchr(bytes, 0, length);
+		last = end != NULL;
+		run = last ? end - bytes : length;
+		//the null is used up as well
+		used = last ? run + 1 : run;
+		fieldLength += used;
+	}
+	received += used;
+	if (received > elementEnd){
+		error = INVALID_OSC;
+		return length;
+	}
+	argumentData(position, type, bytes, run, last);
+	if (last){
+		endData();
+	}
+	return used;
+}
+
+/*=============================================================================
+	GETTING DATA
+=============================================================================*/
+
+int32_t OSCParser::getInt(){
+	int32_t i;
+	memcpy(&i, incomingBuffer, 4);
+	return BigEndian(i);
+}
+
+float OSCParser::getFloat(){
+	float f;
+	memcpy(&f, incomingBuffer, 4);
+	return BigEndian(f);
+}
+
+double OSCParser::getDouble(){
+	union {
+		uint64_t l;
+		double d;
+	} u;
+	memcpy(&u.l, incomingBuffer, 8);
+	u.l = BigEndian(u.l);
+	return u.d;
+}
+
+uint64_t OSCParser::getTime(){
+	uint64_t t;
+	memcpy(&t, incomingBuffer, 8);
+	return BigEndian(t);
+}
+
+const char * OSCParser::getAddress(){
+	return address;
+}
+
+const char * OSCParser::getTypes(){
+	return types;
+}
+
+/*=============================================================================
+	ERROR HANDLING
+=============================================================================*/
+
+bool OSCParser::hasError(){
+	return error != OSC_OK;
+}
+
+OSCErrorCode OSCParser::getError(){
+	return error;
+}
@@ -0,0 +1,228 @@
+/*
+ The Center for New Music and Audio Technologies,
+ University of California, Berkeley.  Copyright (c) 2014, The Regents of
+ the University of California (Regents).
+ 
+ Permission to use, copy, modify, distribute, and distribute modified versions
+ of this software and its documentation without fee and without a signed
+ licensing agreement, is hereby granted, provided that the above copyright
+ notice, this paragraph and the following two paragraphs appear in all copies,
+ modifications, and distributions.
+ 
+ IN NO EVENT SHALL REGENTS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS, ARISING
+ OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF REGENTS HAS
+ BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE. THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED
+ HEREUNDER IS PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE
+ MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+
+#ifndef OSCPARSER_h
+#define OSCPARSER_h
+
+#include "OSCData.h"
+
+//the longest address, including its null
+#ifndef OSC_PARSER_MAX_ADDRESS
+#define OSC_PARSER_MAX_ADDRESS 64
+#endif
+
+//the most type tags in one message
+#ifndef OSC_PARSER_MAX_TYPES
+#define OSC_PARSER_MAX_TYPES 32
+#endif
+
+//the most bundles inside each other, including the packet's own
+#ifndef OSC_PARSER_MAX_DEPTH
+#define OSC_PARSER_MAX_DEPTH 4
+#endif
+
+//strings and blobs which arrive a byte at a time are handed on in chunks of this many bytes
+#ifndef OSC_PARSER_CHUNK_SIZE
+#if defined(__AVR__)
+#define OSC_PARSER_CHUNK_SIZE 16
+#else
+#define OSC_PARSER_CHUNK_SIZE 64
+#endif
+#endif
+
+/*
+ parses packets as their bytes arrive and reports what it finds,
+ without building an OSCMessage or OSCBundle
+
+ make a class which inherits from OSCParser and override the events you
+ want. the parser's memory is fixed by the sizes above, however big the
+ packet is: strings and blobs are passed on in pieces as they arrive,
+ so a 64 KB blob can go by on a board with a few KB of RAM.
+
+	class Meter : public OSCParser {
+		void argument(int position, char type){
+			if (type == 'f') level = getFloat();
+		}
+	};
+
+ the bytes of one packet go to fill(), then endPacket() marks its end,
+ which is needed to know where the top-level bundle stops.
+ */
+
+class OSCParser
+{
+
+private:
+
+/*=============================================================================
+	PRIVATE VARIABLES
+=============================================================================*/
+
+	//the decoding states for incoming bytes
+	enum DecodeState {
+		STANDBY,
+		HEADER,
+		TIMETAG,
+		ELEMENT_SIZE,
+		ADDRESS,
+		ADDRESS_PADDING,
+		TYPES,
+		TYPES_PADDING,
+		ARGUMENT,
+		BLOB_SIZE,
+		DATA,
+		DATA_PADDING,
+		DONE,
+	} decodeState;
+
+	//the current message's address and type tags (without the comma)
+	char address[OSC_PARSER_MAX_ADDRESS];
+	int addressLength;
+	char types[OSC_PARSER_MAX_TYPES + 1];
+	int typesLength;
+
+	//the argument being decoded
+	int position;
+
+	//the bundle header, timetag, sizes and fixed size arguments until they're complete
+	uint8_t incomingBuffer[8];
+	int incomingBufferSize;
+	//the number of bytes in the fixed size argument
+	int argumentSize;
+
+	//the string or blob bytes waiting to be handed on
+	uint8_t chunk[OSC_PARSER_CHUNK_SIZE];
+	int chunkLength;
+	//the blob bytes still to come
+	uint32_t dataRemaining;
+
+	//the length of the current address, type tags, string or blob, for its padding
+	int fieldLength;
+	int paddingLeft;
+
+	//the number of bytes of the packet so far
+	uint32_t received;
+	//where the current element of a bundle ends
+	uint32_t elementEnd;
+	//where each of the open bundles ends, the packet's own doesn't have one
+	uint32_t bundleEnds[OSC_PARSER_MAX_DEPTH];
+	int depth;
+
+	//error codes for potential runtime problems
+	OSCErrorCode error;
+
+	//decoding functions
+	void decode(uint8_t);
+	void decodeTimetag();
+	void decodeElementSize();
+	//moves on to the next argument which has bytes, ending the message after the last one
+	void nextArgument();
+	//hands on the chunk
+	void flushChunk(bool last);
+	//the string or blob has all of its bytes
+	void endData();
+	//the message has all of its arguments
+	void endMessage();
+	//the bundle element is over, along with the bundles which end with it
+	void endElement();
+	//hands on as much of a string or blob as there is in the bytes, without copying it
+	//returns the number of bytes used
+	int decodeData(const uint8_t * bytes, int length);
+
+	//starts over for the next packet
+	void reset();
+
+public:
+
+/*=============================================================================
+	CONSTRUCTORS / DESTRUCTOR
+=============================================================================*/
+
+	OSCParser();
+
+	virtual ~OSCParser();
+
+/*=============================================================================
+	FILLING
+=============================================================================*/
+
+	//the events are called from inside fill as the bytes arrive
+	void fill(uint8_t incomingByte);
+	void fill(const uint8_t * incomingBytes, int length);
+
+	//the packet is over, returns false if it had an error or was cut short
+	//the parser is ready for the next packet either way
+	bool endPacket();
+
+/*=============================================================================
+	EVENTS
+
+	they do nothing unless they're overridden
+=============================================================================*/
+
+	//a bundle (the packet's own, or one inside it) starts, with its timetag
+	virtual void bundleBegin(uint64_t /*timetag*/){}
+	virtual void bundleEnd(){}
+
+	//a message starts, the type tags are without the comma
+	//both are null terminated and stay valid until the message ends
+	virtual void messageBegin(const char * /*address*/, const char * /*types*/){}
+	virtual void messageEnd(){}
+
+	//an argument with a fixed size ('i' 'f' 'd' 't' ... and 'T' 'F' 'N' 'I')
+	//its value can be read with the getters below until the event returns
+	virtual void argument(int /*position*/, char /*type*/){}
+
+	//a piece of a string ('s' 'S') or blob ('b'), the pieces come in order
+	//a string's null isn't included, the last piece can be empty
+	virtual void argumentData(int /*position*/, char /*type*/, const uint8_t * /*bytes*/, int /*length*/, bool /*last*/){}
+
+/*=============================================================================
+	GETTING DATA
+
+	the value of the argument passed to argument()
+=============================================================================*/
+
+	//'i' 'c' 'r' 'm'
+	int32_t getInt();
+	float getFloat();
+	double getDouble();
+	//'t', or the bits of an 'h'
+	uint64_t getTime();
+
+	//the current message's address and type tags
+	const char * getAddress();
+	const char * getTypes();
+
+/*=============================================================================
+	ERROR
+=============================================================================*/
+
+	bool hasError();
+
+	OSCErrorCode getError();
+
+};
+
+#endif
@@ -0,0 +1,350 @@
+/*
+ The Center for New Music and Audio Technologies,
+ University of California, Berkeley.  Copyright (c) 2014, The Regents of
+ the University of California (Regents).
+ 
+ Permission to use, copy, modify, distribute, and distribute modified versions
+ of this software and its documentation without fee and without a signed
+ licensing agreement, is hereby granted, provided that the above copyright
+ notice, this paragraph and the following two paragraphs appear in all copies,
+ modifications, and distributions.
+ 
+ IN NO EVENT SHALL REGENTS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS, ARISING
+ OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF REGENTS HAS
+ BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE. THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED
+ HEREUNDER IS PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE
+ MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+#include "OSCPattern.h"
+#include "OSCMatch.h"
+#include <stdlib.h>
+#include <string.h>
+
+//the steps a pattern compiles to
+#define PATTERN_END			0
+//a '/'
+#define PATTERN_SLASH		1
+//followed by a count and that many characters
+#define PATTERN_LITERAL		2
+//a '?'
+#define PATTERN_ANY			3
+//followed by a bitmap of the characters below 128
+#define PATTERN_CLASS		4
+//the same, but matches the characters which aren't in the bitmap
+#define PATTERN_NOT_CLASS	5
+//followed by a count, then each alternative's length and characters
+#define PATTERN_CHOICE		6
+//a '*'
+#define PATTERN_STAR		7
+
+#define PATTERN_BITMAP_SIZE	16
+
+static bool isSpecial(char c){
+	return c == '/' || c == '?' || c == '*' || c == '[' || c == '{' || c == '\0';
+}
+
+static bool hasWildcards(const char * s){
+	return strpbrk(s, "*?[{") != NULL;
+}
+
+/*=============================================================================
+	CONSTRUCTORS / DESTRUCTOR
+=============================================================================*/
+
+OSCPattern::OSCPattern(const char * _pattern){
+	program = NULL;
+	pattern = "";
+	patternLength = 0;
+	literal = false;
+	error = OSC_OK;
+	int size = compile(_pattern, NULL);
+	if (size < 0){
+		error = INVALID_OSC;
+		return;
+	}
+	int length = strlen(_pattern) + 1;
+	program = (uint8_t *) malloc(size + length);
+	if (program == NULL){
+		error = ALLOCFAILED;
+		return;
+	}
+	compile(_pattern, program);
+	memcpy(program + size, _pattern, length);
+	pattern = (const char *) program + size;
+	patternLength = length - 1;
+	literal = !hasWildcards(pattern);
+}
+
+OSCPattern::~OSCPattern(){
+	free(program);
+}
+
+/*=============================================================================
+	COMPILING
+=============================================================================*/
+
+int OSCPattern::compile(const char * p, uint8_t * out){
+	int size = 0;
+	while (true){
+		char c = *p;
+		if (c == '\0'){
+			if (out != NULL){
+				out[size] = PATTERN_END;
+			}
+			return size + 1;
+		} else if (c == '/'){
+			if (out != NULL){
+				out[size] = PATTERN_SLASH;
+			}
+			size++;
+			p++;
+		} else if (c == '?'){
+			if (out != NULL){
+				out[size] = PATTERN_ANY;
+			}
+			size++;
+			p++;
+		} else if (c == '*'){
+			//"**" matches the same as "*"
+			if (out != NULL){
+				out[size] = PATTERN_STAR;
+			}
+			size++;
+			while (*p == '*'){
+				p++;
+			}
+		} else if (c == '['){
+			p++;
+			bool negated = *p == '!';
+			if (negated){
+				p++;
+			}
+			uint8_t * bitmap = out != NULL ? out + size + 1 : NULL;
+			if (out != NULL){
+				out[size] = negated ? PATTERN_NOT_CLASS : PATTERN_CLASS;
+				memset(bitmap, 0, PATTERN_BITMAP_SIZE);
+			}
+			while (*p != ']'){
+				if (*p == '\0' || *p == '/'){
+					return -1;
+				}
+				uint8_t first = *p;
+				uint8_t last = first;
+				//a '-' at the end is just a '-'
+				if (p[1] == '-' && p[2] != ']' && p[2] != '\0'){
+					last = p[2];
+					p += 3;
+				} else {
+					p++;
+				}
+				for (int ch = first; ch <= last && ch < 128; ch++){
+					if (bitmap != NULL){
+						bitmap[ch >> 3] |= 1 << (ch & 7);
+					}
+				}
+			}
+			p++;
+			size += 1 + PATTERN_BITMAP_SIZE;
+		} else if (c == '{'){
+			p++;
+			int countAt = size + 1;
+			int count = 0;
+			size += 2;
+			while (true){
+				const char * start = p;
+				while (*p != ',' && *p != '}'){
+					if (*p == '\0' || *p == '/'){
+						return -1;
+					}
+					p++;
+				}
+				int length = p - start;
+				if (length > 255 || count == 255){
+					return -1;
+				}
+				if (out != NULL){
+					out[size] = length;
+					memcpy(out + size + 1, start, length);
+				}
+				size += 1 + length;
+				count++;
+				if (*p++ == '}'){
+					break;
+				}
+			}
+			if (out != NULL){
+				out[countAt - 1] = PATTERN_CHOICE;
+				out[countAt] = count;
+			}
+		} else {
+			//a run of plain characters
+			const char * start = p;
+			while (!isSpecial(*p) && p - start < 255){
+				p++;
+			}
+			int length = p - start;
+			if (out != NULL){
+				out[size] = PATTERN_LITERAL;
+				out[size + 1] = length;
+				memcpy(out + size + 2, start, length);
+			}
+			size += 2 + length;
+		}
+	}
+}
+
+/*=============================================================================
+	MATCHING
+=============================================================================*/
+
+int OSCPattern::run(const char * address, bool full) const{
+	const uint8_t * step = program;
+	const char * a = address;
+	//where to go back to when something after a '*' doesn't match
+	const uint8_t * starStep = NULL;
+	const char * starAddress = NULL;
+	while (true){
+		bool matched;
+		switch (*step){
+			case PATTERN_END:
+				matched = *a == '\0' || (!full && *a == '/');
+				if (matched){
+					return a - address;
+				}
+				break;
+			case PATTERN_SLASH:
+				matched = *a == '/';
+				if (matched){
+					//a '*' can't reach past this
+					starStep = NULL;
+					a++;
+					step++;
+				}
+				break;
+			case PATTERN_LITERAL:
+			{
+				int length = step[1];
+				matched = strncmp(a, (const char *) step + 2, length) == 0;
+				if (matched){
+					a += length;
+					step += 2 + length;
+				}
+				break;
+			}
+			case PATTERN_ANY:
+				matched = *a != '\0' && *a != '/';
+				if (matched){
+					a++;
+					step++;
+				}
+				break;
+			case PATTERN_CLASS:
+			case PATTERN_NOT_CLASS:
+			{
+				uint8_t ch = *a;
+				bool inClass = ch < 128 && (step[1 + (ch >> 3)] & (1 << (ch & 7)));
+				matched = ch != '\0' && ch != '/' && inClass == (*step == PATTERN_CLASS);
+				if (matched){
+					a++;
+					step += 1 + PATTERN_BITMAP_SIZE;
+				}
+				break;
+			}
+			case PATTERN_CHOICE:
+			{
+				//the first alternative which matches is taken, like osc_match
+				int count = step[1];
+				const uint8_t * choice = step + 2;
+				int matchedLength = -1;
+				for (int i = 0; i < count; i++){
+					int length = choice[0];
+					if (matchedLength < 0 && strncmp(a, (const char *) choice + 1, length) == 0){
+						matchedLength = length;
+					}
+					choice += 1 + length;
+				}
+				matched = matchedLength >= 0;
+				if (matched){
+					a += matchedLength;
+					step = choice;
+				}
+				break;
+			}
+			case PATTERN_STAR:
+				//start by matching nothing
+				starStep = ++step;
+				starAddress = a;
+				continue;
+			default:
+				return -1;
+		}
+		if (!matched){
+			//let the last '*' take one more character, as long as it stays in its part of the address
+			if (starStep == NULL || *starAddress == '\0' || *starAddress == '/'){
+				return -1;
+			}
+			a = ++starAddress;
+			step = starStep;
+		}
+	}
+}
+
+int OSCPattern::match(const char * address) const{
+	if (program == NULL || address == NULL){
+		return 0;
+	}
+	if (literal && strncmp(address, pattern, patternLength) == 0 && (address[patternLength] == '\0' || address[patternLength] == '/')){
+		return patternLength;
+	}
+	if (hasWildcards(address)){
+		int addressOffset;
+		int patternOffset;
+		int ret = osc_match(address, pattern, &addressOffset, &patternOffset);
+		if (ret == 3 || (addressOffset > 0 && address[addressOffset] == '/')){
+			return addressOffset;
+		}
+		return 0;
+	}
+	if (literal){
+		return 0;
+	}
+	int matched = run(address, false);
+	return matched > 0 ? matched : 0;
+}
+
+bool OSCPattern::fullMatch(const char * address) const{
+	if (program == NULL || address == NULL){
+		return false;
+	}
+	if (literal && strcmp(address, pattern) == 0){
+		return true;
+	}
+	if (hasWildcards(address)){
+		int addressOffset;
+		int patternOffset;
+		return osc_match(address, pattern, &addressOffset, &patternOffset) == 3;
+	}
+	return !literal && run(address, true) >= 0;
+}
+
+const char * OSCPattern::getPattern() const{
+	return pattern;
+}
+
+/*=============================================================================
+	ERRORS
+=============================================================================*/
+
+bool OSCPattern::hasError() const{
+	return error != OSC_OK;
+}
+
+OSCErrorCode OSCPattern::getError() const{
+	return error;
+}
@@ -0,0 +1,100 @@
+/*
+ The Center for New Music and Audio Technologies,
+ University of California, Berkeley.  Copyright (c) 2014, The Regents of
+ the University of California (Regents).
+ 
+ Permission to use, copy, modify, distribute, and distribute modified versions
+ of this software and its documentation without fee and without a signed
+ licensing agreement, is hereby granted, provided that the above copyright
+ notice, this paragraph and the following two paragraphs appear in all copies,
+ modifications, and distributions.
+ 
+ IN NO EVENT SHALL REGENTS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS, ARISING
+ OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF REGENTS HAS
+ BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE. THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED
+ HEREUNDER IS PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE
+ MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+#ifndef OSCPATTERN_h
+#define OSCPATTERN_h
+
+#include "OSCData.h"
+
+/*
+ an address pattern compiled once, to be matched many times
+
+ the pattern is turned into a list of steps (runs of characters, '/',
+ '?', '[]' classes kept as bitmaps, '{}' alternatives and '*') which are
+ matched against the address front to back. only a '*' ever goes back,
+ and never past the '/' which ends its part of the address.
+
+ an address which has wildcards of its own is matched with osc_match,
+ the same way as when the pattern is passed as a string.
+ */
+
+class OSCPattern
+{
+
+private:
+
+	//the steps, followed by a copy of the pattern
+	uint8_t * program;
+	const char * pattern;
+	int patternLength;
+	//there are no wildcards, so it's matched by comparing the strings
+	bool literal;
+
+	OSCErrorCode error;
+
+	//writes the steps to out, or just counts their size if out is NULL
+	//returns -1 if the pattern is malformed
+	static int compile(const char * pattern, uint8_t * out);
+
+	//the number of characters of the address matched by the steps, -1 if it didn't match
+	int run(const char * address, bool full) const;
+
+	//not copyable
+	OSCPattern(const OSCPattern &);
+	OSCPattern & operator=(const OSCPattern &);
+
+public:
+
+/*=============================================================================
+	CONSTRUCTORS / DESTRUCTOR
+=============================================================================*/
+
+	OSCPattern(const char * pattern);
+
+	~OSCPattern();
+
+/*=============================================================================
+	MATCHING
+=============================================================================*/
+
+	//returns the number of characters matched in the address
+	//only counts if the match ends at a '/' or at the end of the address
+	int match(const char * address) const;
+
+	//returns true only if the whole address matched
+	bool fullMatch(const char * address) const;
+
+	//the pattern it was compiled from
+	const char * getPattern() const;
+
+/*=============================================================================
+	ERRORS
+=============================================================================*/
+
+	//INVALID_OSC for an unclosed '[' or '{', ALLOCFAILED if there wasn't memory
+	bool hasError() const;
+
+	OSCErrorCode getError() const;
+};
+
+#endif
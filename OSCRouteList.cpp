@@ -0,0 +1,221 @@
+/*
+ The Center for New Music and Audio Technologies,
+ University of California, Berkeley.  Copyright (c) 2014, The Regents of
+ the University of California (Regents).
+ 
+ Permission to use, copy, modify, distribute, and distribute modified versions
+ of this software and its documentation without fee and without a signed
+ licensing agreement, is hereby granted, provided that the above copyright
+ notice, this paragraph and the following two paragraphs appear in all copies,
+ modifications, and distributions.
+ 
+ IN NO EVENT SHALL REGENTS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS, ARISING
+ OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF REGENTS HAS
+ BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE. THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED
+ HEREUNDER IS PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE
+ MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+#include "OSCRouteList.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*=============================================================================
+	CONSTRUCTORS / DESTRUCTOR
+=============================================================================*/
+
+OSCRouteList::OSCRouteList(int size){
+	error = OSC_OK;
+	routes = (Route *) malloc(size * sizeof(Route));
+	routesSize = size;
+	if (routes == NULL){
+		routesSize = 0;
+		error = ALLOCFAILED;
+	}
+	numRoutes = 0;
+	ordering = ORDER_FIXED;
+	interval = 32;
+	untilSort = interval;
+	stopOnMatch = false;
+	depth = 0;
+}
+
+OSCRouteList::~OSCRouteList(){
+	free(routes);
+}
+
+void OSCRouteList::empty(){
+	numRoutes = 0;
+	untilSort = interval;
+	if (routes != NULL){
+		error = OSC_OK;
+	}
+}
+
+/*=============================================================================
+	REGISTERING
+=============================================================================*/
+
+bool OSCRouteList::add(const char * pattern, bool partial){
+	if (numRoutes == routesSize){
+		error = BUFFER_FULL;
+		return false;
+	}
+	Route & route = routes[numRoutes++];
+	route.pattern = pattern;
+	route.partial = partial;
+	route.hits = 0;
+	return true;
+}
+
+bool OSCRouteList::addDispatch(const char * pattern, void (*callback)(OSCMessage &)){
+	if (!add(pattern, false)){
+		return false;
+	}
+	routes[numRoutes - 1].callback.dispatch = callback;
+	return true;
+}
+
+bool OSCRouteList::addRoute(const char * pattern, void (*callback)(OSCMessage &, int)){
+	if (!add(pattern, true)){
+		return false;
+	}
+	routes[numRoutes - 1].callback.route = callback;
+	return true;
+}
+
+/*=============================================================================
+	ORDERING
+=============================================================================*/
+
+void OSCRouteList::setOrdering(Ordering _ordering, int _interval){
+	ordering = _ordering;
+	interval = _interval > 0 ? _interval : 1;
+	untilSort = interval;
+}
+
+void OSCRouteList::setStopOnMatch(bool stop){
+	stopOnMatch = stop;
+}
+
+void OSCRouteList::toFront(int position){
+	if (position == 0){
+		return;
+	}
+	Route route = routes[position];
+	memmove(routes + 1, routes, position * sizeof(Route));
+	routes[0] = route;
+}
+
+void OSCRouteList::sort(){
+	//insertion sort, the list is mostly in order already after the first time
+	//and routes with the same count keep their order
+	for (int i = 1; i < numRoutes; i++){
+		Route route = routes[i];
+		int j = i;
+		while (j > 0 && routes[j - 1].hits < route.hits){
+			routes[j] = routes[j - 1];
+			j--;
+		}
+		routes[j] = route;
+	}
+	//older matches count for less, so the order follows the traffic
+	for (int i = 0; i < numRoutes; i++){
+		routes[i].hits >>= 1;
+	}
+	untilSort = interval;
+}
+
+void OSCRouteList::tick(){
+	if (ordering == ORDER_BY_COUNT && --untilSort <= 0){
+		sort();
+	}
+}
+
+const char * OSCRouteList::getPattern(int position){
+	if (position < 0 || position >= numRoutes){
+		return NULL;
+	}
+	return routes[position].pattern;
+}
+
+int OSCRouteList::getHits(int position){
+	if (position < 0 || position >= numRoutes){
+		return 0;
+	}
+	return routes[position].hits;
+}
+
+/*=============================================================================
+	DISPATCHING
+=============================================================================*/
+
+int OSCRouteList::match(OSCMessage & msg, int offset){
+	if (msg.address == NULL){
+		return 0;
+	}
+	int called = 0;
+	for (int i = 0; i < numRoutes; i++){
+		Route & route = routes[i];
+		bool matched = route.partial ? msg.route(route.pattern, route.callback.route, offset)
+			: msg.dispatch(route.pattern, route.callback.dispatch, offset);
+		if (!matched){
+			continue;
+		}
+		called++;
+		if (route.hits < 0xFFFF){
+			route.hits++;
+		}
+		//a dispatch from inside a callback leaves the order alone,
+		//so the outer one doesn't lose its place
+		if (ordering == ORDER_MOVE_TO_FRONT && depth == 1){
+			//the routes before it move up one, so the next one to try is still at i + 1
+			toFront(i);
+		}
+		if (stopOnMatch){
+			break;
+		}
+	}
+	if (depth == 1){
+		tick();
+	}
+	return called;
+}
+
+int OSCRouteList::dispatch(OSCMessage & msg, int offset){
+	depth++;
+	int called = match(msg, offset);
+	depth--;
+	return called;
+}
+
+int OSCRouteList::dispatch(OSCBundle & bundle, int offset){
+	depth++;
+	int called = 0;
+	for (int i = 0; i < bundle.size(); i++){
+		called += match(*bundle.getOSCMessage(i), offset);
+	}
+	depth--;
+	return called;
+}
+
+/*=============================================================================
+	SIZE / ERRORS
+=============================================================================*/
+
+int OSCRouteList::size(){
+	return numRoutes;
+}
+
+bool OSCRouteList::hasError(){
+	return error != OSC_OK;
+}
+
+OSCErrorCode OSCRouteList::getError(){
+	return error;
+}
@@ -0,0 +1,179 @@
+/*
+ The Center for New Music and Audio Technologies,
+ University of California, Berkeley.  Copyright (c) 2014, The Regents of
+ the University of California (Regents).
+ 
+ Permission to use, copy, modify, distribute, and distribute modified versions
+ of this software and its documentation without fee and without a signed
+ licensing agreement, is hereby granted, provided that the above copyright
+ notice, this paragraph and the following two paragraphs appear in all copies,
+ modifications, and distributions.
+ 
+ IN NO EVENT SHALL REGENTS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS, ARISING
+ OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF REGENTS HAS
+ BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE. THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED
+ HEREUNDER IS PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE
+ MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+#ifndef OSCROUTELIST_h
+#define OSCROUTELIST_h
+
+#include "OSCBundle.h"
+
+/*
+ the chain of msg.dispatch(...) and msg.route(...) calls from the
+ examples, kept in a list which learns which patterns are hit most
+
+ every pattern is still tried with osc_match, as the chain would, but the
+ ones which match often are moved towards the front: with early exit on,
+ a message stops at the first pattern it matches, so the usual messages
+ cost a compare or two instead of a walk down the whole list.
+
+ each route takes a pattern pointer, a callback and a hit counter, and
+ the room for them is allocated once when the list is made. nothing is
+ built per address, so it's a fit for boards which can't spare the RAM
+ for an OSCRouter.
+
+ the order only saves time with early exit on, without it every pattern
+ is tried anyway. reordering changes the order the callbacks are called
+ in when more than one pattern matches a message, and early exit assumes
+ that one message is handled by one pattern only.
+ */
+
+class OSCRouteList
+{
+
+public:
+
+	//how the routes are kept in order
+	enum Ordering {
+		//the order they were added in
+		ORDER_FIXED,
+		//a route which matches is moved to the front
+		ORDER_MOVE_TO_FRONT,
+		//every so often the routes are sorted by how often they matched lately
+		ORDER_BY_COUNT
+	};
+
+private:
+
+	struct Route {
+		//not copied, the pattern has to outlast the list
+		const char * pattern;
+		union {
+			void (*dispatch)(OSCMessage &);
+			void (*route)(OSCMessage &, int);
+		} callback;
+		bool partial;
+		//matches since the last sort, halved after each one
+		uint16_t hits;
+	};
+
+/*=============================================================================
+	PRIVATE VARIABLES
+=============================================================================*/
+
+	Route * routes;
+	int numRoutes;
+	int routesSize;
+
+	Ordering ordering;
+	//the number of dispatches between sorts
+	int interval;
+	int untilSort;
+	bool stopOnMatch;
+
+	//how many dispatches are running, the list is only reordered by the outermost one
+	int depth;
+
+	OSCErrorCode error;
+
+	bool add(const char * pattern, bool partial);
+	//tries each route, returns the number of callbacks called
+	int match(OSCMessage & msg, int offset);
+	//moves the route at the position to the front
+	void toFront(int position);
+	//counts a dispatch, sorting when it's time
+	void tick();
+
+	//not copyable
+	OSCRouteList(const OSCRouteList &);
+	OSCRouteList & operator=(const OSCRouteList &);
+
+public:
+
+/*=============================================================================
+	CONSTRUCTORS / DESTRUCTOR
+=============================================================================*/
+
+	//room for that many routes
+	OSCRouteList(int size);
+
+	~OSCRouteList();
+
+	//removes all of the routes
+	void empty();
+
+/*=============================================================================
+	REGISTERING
+
+	the pattern isn't copied, a string literal is fine
+	each returns false if the list is full
+=============================================================================*/
+
+	//the callback is called with messages whose address fully matches, like msg.dispatch
+	bool addDispatch(const char * pattern, void (*callback)(OSCMessage &));
+
+	//the callback is called with messages whose address starts with the pattern, like msg.route
+	bool addRoute(const char * pattern, void (*callback)(OSCMessage &, int));
+
+/*=============================================================================
+	ORDERING
+=============================================================================*/
+
+	//ORDER_BY_COUNT sorts after every interval dispatches
+	void setOrdering(Ordering, int interval = 32);
+
+	//stop at the first route which matches, instead of trying the rest
+	void setStopOnMatch(bool);
+
+	//sorts the routes by their counts now
+	void sort();
+
+	//the pattern tried at that position, NULL if there isn't one
+	const char * getPattern(int position);
+
+	//the matches counted for the route at that position since the last sort
+	int getHits(int position);
+
+/*=============================================================================
+	DISPATCHING
+
+	returns the number of callbacks which were called
+=============================================================================*/
+
+	//matches the address from the offset on, for routing from inside a route callback
+	int dispatch(OSCMessage & msg, int offset = 0);
+
+	//dispatches each message in the bundle
+	int dispatch(OSCBundle & bundle, int offset = 0);
+
+/*=============================================================================
+	SIZE / ERRORS
+=============================================================================*/
+
+	//the number of routes
+	int size();
+
+	bool hasError();
+
+	OSCErrorCode getError();
+};
+
+#endif
@@ -0,0 +1,813 @@
+/*
+ The Center for New Music and Audio Technologies,
+ University of California, Berkeley.  Copyright (c) 2014, The Regents of
+ the University of California (Regents).
+ 
+ Permission to use, copy, modify, distribute, and distribute modified versions
+ of this software and its documentation without fee and without a signed
+ licensing agreement, is hereby granted, provided that the above copyright
+ notice, this paragraph and the following two paragraphs appear in all copies,
+ modifications, and distributions.
+ 
+ IN NO EVENT SHALL REGENTS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS, ARISING
+ OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF REGENTS HAS
+ BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE. THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED
+ HEREUNDER IS PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE
+ MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+#include "OSCRouter.h"
+#include "OSCMatch.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+//the most names a segment with [] or {} in it is turned into and looked up one by one,
+//beyond that the children are scanned
+#ifndef OSC_ROUTER_MAX_EXPANSIONS
+#define OSC_ROUTER_MAX_EXPANSIONS 32
+#endif
+//the longest name it's turned into
+#define OSC_ROUTER_MAX_NAME 32
+
+struct OSCRouteNode {
+	//where the segment's name starts in names
+	int name;
+	int firstChild;
+	int nextSibling;
+	int firstHandler;
+	//where the children are in the router's sorted list, set by sortChildren
+	int childStart;
+	int childCount;
+	//the children with wildcards or captures, after the others in the sorted list
+	int patternCount;
+	//the name has wildcards in it
+	bool wild;
+	//the name is "%i"
+	bool capture;
+};
+
+//the kinds of callback
+#define ROUTE_DISPATCH			0
+#define ROUTE_ROUTE				1
+#define ROUTE_DISPATCH_CAPTURES	2
+#define ROUTE_ROUTE_CAPTURES	3
+#define ROUTE_BIND				4
+
+struct OSCRouteHandler {
+	union {
+		void (*dispatch)(OSCMessage &);
+		void (*route)(OSCMessage &, int);
+		void (*dispatchCaptures)(OSCMessage &, const int *);
+		void (*routeCaptures)(OSCMessage &, int, const int *);
+		//the user's callback, cast back to its type by bind
+		void (*bound)();
+	} callback;
+	uint8_t kind;
+	//for ROUTE_BIND, fills in the struct and calls the callback
+	bool (*bind)(OSCMessage &, const char *, void (*)(), const int *);
+	//where the type tags are in names
+	int types;
+	//the next handler at the same node
+	int next;
+	//the last dispatch it was called in
+	unsigned int pass;
+	//the last find it was found by
+	unsigned int lookup;
+};
+
+static bool isWild(const char * segment, int length){
+	for (int i = 0; i < length; i++){
+		char c = segment[i];
+		if (c == '*' || c == '?' || c == '[' || c == '{'){
+			return true;
+		}
+	}
+	return false;
+}
+
+//reads a segment which is a whole number that fits in an int
+static bool parseInt(const char * segment, int length, int * value){
+	bool negative = length > 0 && segment[0] == '-';
+	int i = negative ? 1 : 0;
+	if (i == length){
+		return false;
+	}
+	int result = 0;
+	for (; i < length; i++){
+		if (segment[i] < '0' || segment[i] > '9'){
+			return false;
+		}
+		int digit = segment[i] - '0';
+		//checked before multiplying so it can't overflow where long is as narrow as int
+		if (result > (INT_MAX - digit) / 10){
+			return false;
+		}
+		result = result * 10 + digit;
+	}
+	*value = negative ? -result : result;
+	return true;
+}
+
+//whether c is in the [] class which starts at the pointer, negated classes aren't listed
+static bool inClass(const char * bracket, char c){
+	for (const char * member = bracket + 1; *member != ']'; member++){
+		if (member[1] == '-' && member[2] != ']'){
+			if (c >= member[0] && c <= member[2]){
+				return true;
+			}
+			member += 2;
+		} else if (*member == c){
+			return true;
+		}
+	}
+	return false;
+}
+
+//the lowest and highest characters in the [] class
+static void classRange(const char * bracket, int * low, int * high){
+	*low = 128;
+	*high = 0;
+	for (const char * member = bracket + 1; *member != ']'; member++){
+		uint8_t first = member[0];
+		uint8_t last = first;
+		if (member[1] == '-' && member[2] != ']'){
+			last = member[2];
+			member += 2;
+		}
+		*low = first < *low ? first : *low;
+		*high = last > *high ? last : *high;
+	}
+	*high = *high < 127 ? *high : 127;
+}
+
+//the number of names a segment with [] and {} in it stands for, or 0 if they can't be listed
+//because of a '*', '?' or negated class, choices of different lengths or there'd be too many
+static int expansions(const char * segment, int length){
+	int count = 1;
+	int nameLength = 0;
+	int at = 0;
+	while (at < length){
+		char c = segment[at];
+		if (c == '*' || c == '?'){
+			return 0;
+		} else if (c == '['){
+			const char * close = (const char *) memchr(segment + at, ']', length - at);
+			if (close == NULL || segment[at + 1] == '!'){
+				return 0;
+			}
+			int members = 0;
+			int low, high;
+			classRange(segment + at, &low, &high);
+			for (int ch = low; ch <= high; ch++){
+				members += inClass(segment + at, ch);
+			}
+			count *= members;
+			nameLength++;
+			at = close - segment + 1;
+		} else if (c == '{'){
+			const char * close = (const char *) memchr(segment + at, '}', length - at);
+			if (close == NULL){
+				return 0;
+			}
+			int choices = 0;
+			int choiceLength = -1;
+			const char * choice = segment + at + 1;
+			while (choice <= close){
+				int n = 0;
+				while (choice + n < close && choice[n] != ','){
+					n++;
+				}
+				if (choiceLength >= 0 && n != choiceLength){
+					return 0;
+				}
+				choiceLength = n;
+				choices++;
+				choice += n + 1;
+			}
+			count *= choices;
+			nameLength += choiceLength;
+			at = close - segment + 1;
+		} else {
+			nameLength++;
+			at++;
+		}
+		if (count == 0 || count > OSC_ROUTER_MAX_EXPANSIONS || nameLength >= OSC_ROUTER_MAX_NAME){
+			return 0;
+		}
+	}
+	return count;
+}
+
+//doubles the array when it's full, returns false if that fails
+static bool grow(void ** array, int count, int * size, size_t itemSize){
+	if (count < *size){
+		return true;
+	}
+	int newSize = *size > 0 ? *size * 2 : 4;
+	void * newArray = realloc(*array, newSize * itemSize);
+	if (newArray == NULL){
+		return false;
+	}
+	*array = newArray;
+	*size = newSize;
+	return true;
+}
+
+/*=============================================================================
+	CONSTRUCTORS / DESTRUCTOR
+=============================================================================*/
+
+OSCRouter::OSCRouter(){
+	nodes = NULL;
+	numNodes = 0;
+	nodesSize = 0;
+	handlers = NULL;
+	numHandlers = 0;
+	handlersSize = 0;
+	names = NULL;
+	namesLength = 0;
+	sorted = NULL;
+	sortedValid = false;
+	numCaptures = 0;
+	captureBase = 0;
+	found = NULL;
+	foundSize = 0;
+	numFound = 0;
+	pass = 0;
+	lookup = 0;
+	depth = 0;
+	error = OSC_OK;
+}
+
+OSCRouter::~OSCRouter(){
+	free(nodes);
+	free(handlers);
+	free(names);
+	free(sorted);
+}
+
+void OSCRouter::empty(){
+	free(nodes);
+	free(handlers);
+	free(names);
+	free(sorted);
+	sorted = NULL;
+	sortedValid = false;
+	nodes = NULL;
+	numNodes = 0;
+	nodesSize = 0;
+	handlers = NULL;
+	numHandlers = 0;
+	handlersSize = 0;
+	names = NULL;
+	namesLength = 0;
+	pass = 0;
+	lookup = 0;
+	error = OSC_OK;
+}
+
+/*=============================================================================
+	REGISTERING
+=============================================================================*/
+
+int OSCRouter::addDispatch(const char * address, void (*callback)(OSCMessage &)){
+	int handler = add(address, ROUTE_DISPATCH);
+	if (handler >= 0){
+		handlers[handler].callback.dispatch = callback;
+	}
+	return handler;
+}
+
+int OSCRouter::addRoute(const char * address, void (*callback)(OSCMessage &, int)){
+	int handler = add(address, ROUTE_ROUTE);
+	if (handler >= 0){
+		handlers[handler].callback.route = callback;
+	}
+	return handler;
+}
+
+int OSCRouter::addDispatch(const char * address, void (*callback)(OSCMessage &, const int *)){
+	int handler = add(address, ROUTE_DISPATCH_CAPTURES);
+	if (handler >= 0){
+		handlers[handler].callback.dispatchCaptures = callback;
+	}
+	return handler;
+}
+
+int OSCRouter::addRoute(const char * address, void (*callback)(OSCMessage &, int, const int *)){
+	int handler = add(address, ROUTE_ROUTE_CAPTURES);
+	if (handler >= 0){
+		handlers[handler].callback.routeCaptures = callback;
+	}
+	return handler;
+}
+
+int OSCRouter::addBinding(const char * address, const char * types, int size, int alignment, BindCall call, void (*callback)()){
+	if (oscStructSize(types) != size || oscStructAlignment(types) != alignment){
+		return -1;
+	}
+	int handler = add(address, ROUTE_BIND);
+	if (handler < 0){
+		return -1;
+	}
+	//the type tags are kept with the names
+	int length = strlen(types);
+	char * newNames = (char *) realloc(names, namesLength + length + 1);
+	if (newNames == NULL){
+		error = ALLOCFAILED;
+		//take the handler back out, it's the last one at its node
+		for (int i = 0; i < numNodes; i++){
+			if (nodes[i].firstHandler == handler){
+				nodes[i].firstHandler = -1;
+			}
+		}
+		for (int i = 0; i < handler; i++){
+			if (handlers[i].next == handler){
+				handlers[i].next = -1;
+			}
+		}
+		numHandlers--;
+		return -1;
+	}
+	names = newNames;
+	memcpy(names + namesLength, types, length + 1);
+	handlers[handler].callback.bound = callback;
+	handlers[handler].bind = call;
+	handlers[handler].types = namesLength;
+	namesLength += length + 1;
+	return handler;
+}
+
+int OSCRouter::makeNode(const char * segment, int length){
+	if (!grow((void **) &nodes, numNodes, &nodesSize, sizeof(OSCRouteNode))){
+		error = ALLOCFAILED;
+		return -1;
+	}
+	char * newNames = (char *) realloc(names, namesLength + length + 1);
+	if (newNames == NULL){
+		error = ALLOCFAILED;
+		return -1;
+	}
+	names = newNames;
+	memcpy(names + namesLength, segment, length);
+	names[namesLength + length] = '\0';
+	OSCRouteNode * node = &nodes[numNodes];
+	node->name = namesLength;
+	node->firstChild = -1;
+	node->nextSibling = -1;
+	node->firstHandler = -1;
+	node->childStart = 0;
+	node->childCount = 0;
+	node->patternCount = 0;
+	node->wild = isWild(segment, length);
+	node->capture = length == 2 && segment[0] == '%' && segment[1] == 'i';
+	namesLength += length + 1;
+	//sorted again on the next dispatch
+	sortedValid = false;
+	return numNodes++;
+}
+
+int OSCRouter::child(int node, const char * segment, int length){
+	//the children are kept in the order they were added
+	int last = -1;
+	for (int i = nodes[node].firstChild; i >= 0; i = nodes[i].nextSibling){
+		const char * name = names + nodes[i].name;
+		if (strncmp(name, segment, length) == 0 && name[length] == '\0'){
+			return i;
+		}
+		last = i;
+	}
+	int newNode = makeNode(segment, length);
+	if (newNode < 0){
+		return -1;
+	}
+	if (last < 0){
+		nodes[node].firstChild = newNode;
+	} else {
+		nodes[last].nextSibling = newNode;
+	}
+	return newNode;
+}
+
+int OSCRouter::add(const char * address, uint8_t kind){
+	//the root has no name, handlers registered at "/" go there
+	if (numNodes == 0 && makeNode("", 0) < 0){
+		return -1;
+	}
+	int node = 0;
+	const char * segment = address;
+	while (*segment != '\0'){
+		if (*segment == '/'){
+			segment++;
+			continue;
+		}
+		int length = 0;
+		while (segment[length] != '/' && segment[length] != '\0'){
+			length++;
+		}
+		node = child(node, segment, length);
+		if (node < 0){
+			return -1;
+		}
+		segment += length;
+	}
+	if (!grow((void **) &handlers, numHandlers, &handlersSize, sizeof(OSCRouteHandler))){
+		error = ALLOCFAILED;
+		return -1;
+	}
+	OSCRouteHandler * handler = &handlers[numHandlers];
+	handler->kind = kind;
+	handler->next = -1;
+	handler->pass = 0;
+	handler->lookup = 0;
+	//added to the end, so the handlers at a node are called in the order they were added
+	int last = -1;
+	for (int i = nodes[node].firstHandler; i >= 0; i = handlers[i].next){
+		last = i;
+	}
+	if (last < 0){
+		nodes[node].firstHandler = numHandlers;
+	} else {
+		handlers[last].next = numHandlers;
+	}
+	return numHandlers++;
+}
+
+/*=============================================================================
+	DISPATCHING
+=============================================================================*/
+
+//the node's literal children are kept sorted by name in sorted[], followed by
+//the ones with wildcards or captures in the order they were added
+bool OSCRouter::sortChildren(){
+	int * newSorted = (int *) realloc(sorted, numNodes * sizeof(int));
+	if (newSorted == NULL){
+		error = ALLOCFAILED;
+		return false;
+	}
+	sorted = newSorted;
+	int position = 0;
+	for (int node = 0; node < numNodes; node++){
+		OSCRouteNode * n = &nodes[node];
+		n->childStart = position;
+		n->childCount = 0;
+		n->patternCount = 0;
+		for (int c = n->firstChild; c >= 0; c = nodes[c].nextSibling){
+			if (nodes[c].wild || nodes[c].capture){
+				continue;
+			}
+			//insertion sort, there's usually only a few
+			const char * name = names + nodes[c].name;
+			int i = position + n->childCount++;
+			while (i > n->childStart && strcmp(names + nodes[sorted[i - 1]].name, name) > 0){
+				sorted[i] = sorted[i - 1];
+				i--;
+			}
+			sorted[i] = c;
+		}
+		position += n->childCount;
+		for (int c = n->firstChild; c >= 0; c = nodes[c].nextSibling){
+			if (nodes[c].wild || nodes[c].capture){
+				sorted[position++] = c;
+				n->patternCount++;
+			}
+		}
+	}
+	sortedValid = true;
+	return true;
+}
+
+//the position in sorted[] of the node's first literal child which doesn't come before
+//the prefix, or the first one after all of those which start with it
+int OSCRouter::search(int node, const char * prefix, int length, bool after){
+	int low = nodes[node].childStart;
+	int high = low + nodes[node].childCount;
+	while (low < high){
+		int middle = (low + high) / 2;
+		int cmp = strncmp(names + nodes[sorted[middle]].name, prefix, length);
+		if (cmp < 0 || (after && cmp == 0)){
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+	return low;
+}
+
+int OSCRouter::fire(const char * address, int node, int offset, OSCMessage * msg){
+	const char * rest = address + offset;
+	//the root's address is "/"
+	bool complete = rest[0] == '\0' || (node == 0 && rest[0] == '/' && rest[1] == '\0');
+	int called = 0;
+	for (int i = nodes[node].firstHandler; i >= 0; i = handlers[i].next){
+		OSCRouteHandler * handler = &handlers[i];
+		bool partial = handler->kind == ROUTE_ROUTE || handler->kind == ROUTE_ROUTE_CAPTURES;
+		if (!partial && !complete){
+			continue;
+		}
+		if (handler->kind == ROUTE_BIND && msg != NULL){
+			//called here, so a message with other type tags doesn't count
+			if (!handler->bind(*msg, names + handler->types, handler->callback.bound, captures + captureBase)){
+				continue;
+			}
+		}
+		if (msg == NULL){
+			//just looking, from find(), which lists each handler once
+			if (handler->lookup == lookup){
+				continue;
+			}
+			handler->lookup = lookup;
+			if (numFound < foundSize){
+				found[numFound] = i;
+			}
+			numFound++;
+			called++;
+		} else {
+			handler->pass = pass;
+			called++;
+			switch (handler->kind){
+				case ROUTE_DISPATCH:
+					handler->callback.dispatch(*msg);
+					break;
+				case ROUTE_ROUTE:
+					handler->callback.route(*msg, offset);
+					break;
+				case ROUTE_DISPATCH_CAPTURES:
+					handler->callback.dispatchCaptures(*msg, captures + captureBase);
+					break;
+				case ROUTE_ROUTE_CAPTURES:
+					handler->callback.routeCaptures(*msg, offset, captures + captureBase);
+					break;
+				case ROUTE_BIND:
+					//already called
+					break;
+			}
+		}
+	}
+	return called;
+}
+
+//walks the child named by each of the segment's expansions, name holds the part so far
+int OSCRouter::expand(const char * address, int node, const char * segment, int length, int at, char * name, int nameLength, int end, OSCMessage * msg){
+	while (at < length && segment[at] != '[' && segment[at] != '{'){
+		name[nameLength++] = segment[at++];
+	}
+	if (at == length){
+		int called = 0;
+		//a name sorts before the longer ones which start with it
+		int position = search(node, name, nameLength, false);
+		int last = nodes[node].childStart + nodes[node].childCount;
+		if (position < last){
+			int child = sorted[position];
+			const char * childName = names + nodes[child].name;
+			if (strncmp(childName, name, nameLength) == 0 && childName[nameLength] == '\0'){
+				called += walk(address, child, end, msg);
+			}
+		}
+		//the name is a plain one, so it can be a number for a capture
+		int value;
+		for (position = last; position < last + nodes[node].patternCount; position++){
+			int child = sorted[position];
+			if (nodes[child].capture && numCaptures < OSC_ROUTER_MAX_CAPTURES && parseInt(name, nameLength, &value)){
+				captures[numCaptures++] = value;
+				called += walk(address, child, end, msg);
+				numCaptures--;
+			}
+		}
+		return called;
+	}
+	int called = 0;
+	if (segment[at] == '['){
+		const char * close = (const char *) memchr(segment + at, ']', length - at);
+		int low, high;
+		classRange(segment + at, &low, &high);
+		for (int c = low; c <= high; c++){
+			if (inClass(segment + at, c)){
+				name[nameLength] = c;
+				called += expand(address, node, segment, length, close - segment + 1, name, nameLength + 1, end, msg);
+			}
+		}
+	} else {
+		const char * close = (const char *) memchr(segment + at, '}', length - at);
+		const char * choices = segment + at + 1;
+		const char * choice = choices;
+		while (choice <= close){
+			int n = 0;
+			while (choice + n < close && choice[n] != ','){
+				n++;
+			}
+			//the same choice twice only counts once
+			bool repeated = false;
+			for (const char * other = choices; other < choice && !repeated; other += n + 1){
+				repeated = strncmp(other, choice, n) == 0;
+			}
+			if (!repeated){
+				memcpy(name + nameLength, choice, n);
+				called += expand(address, node, segment, length, close - segment + 1, name, nameLength + n, end, msg);
+			}
+			choice += n + 1;
+		}
+	}
+	return called;
+}
+
+//walks the children between the two positions in sorted[] which match the segment
+int OSCRouter::scan(const char * address, int from, int to, const char * segment, int length, bool wild, int end, OSCMessage * msg){
+	int called = 0;
+	for (int position = from; position < to; position++){
+		int child = sorted[position];
+		const char * name = names + nodes[child].name;
+		if (nodes[child].capture){
+			//numbers are matched by expand, the segments which get here are either
+			//too long to be one or have a '*' or '?' which can't stand for one
+			continue;
+		}
+		bool matched;
+		if (wild || nodes[child].wild){
+			int addressOffset, nameOffset;
+			int ret = osc_match(segment, name, &addressOffset, &nameOffset);
+			//osc_match leaves a '*' with nothing to match at the end of the name
+			while (addressOffset < length && segment[addressOffset] == '*'){
+				addressOffset++;
+			}
+			matched = (ret & OSC_MATCH_ADDRESS_COMPLETE) && addressOffset == length;
+		} else {
+			matched = strncmp(name, segment, length) == 0 && name[length] == '\0';
+		}
+		if (matched){
+			called += walk(address, child, end, msg);
+		}
+	}
+	return called;
+}
+
+//offset is just after the node's segment, at a '/' or the end of the address
+int OSCRouter::walk(const char * address, int node, int offset, OSCMessage * msg){
+	int called = fire(address, node, offset, msg);
+	if (address[offset] != '/'){
+		return called;
+	}
+	const char * segment = address + offset + 1;
+	int length = 0;
+	while (segment[length] != '/' && segment[length] != '\0'){
+		length++;
+	}
+	int end = offset + 1 + length;
+	//the characters before the first wildcard
+	int prefix = 0;
+	while (prefix < length && !isWild(segment + prefix, 1)){
+		prefix++;
+	}
+	bool wild = prefix < length;
+	int first = nodes[node].childStart;
+	int last = first + nodes[node].childCount;
+	//only the children which start the right way can match, the others aren't looked at
+	if (expansions(segment, length) > 0){
+		//few enough names that each one can be looked up
+		char name[OSC_ROUTER_MAX_NAME];
+		called += expand(address, node, segment, length, 0, name, 0, end, msg);
+	} else if (prefix > 0){
+		called += scan(address, search(node, segment, prefix, false), search(node, segment, prefix, true), segment, length, wild, end, msg);
+	} else if (segment[0] == '{' && memchr(segment, '}', length) != NULL){
+		//the children which start with each of the choices
+		const char * choices = segment + 1;
+		const char * close = (const char *) memchr(segment, '}', length);
+		const char * choice = choices;
+		while (choice <= close){
+			int choiceLength = 0;
+			while (choice + choiceLength < close && choice[choiceLength] != ','){
+				choiceLength++;
+			}
+			//a choice which starts with another one has already been covered by it
+			bool covered = false;
+			const char * other = choices;
+			while (other <= close && !covered){
+				int otherLength = 0;
+				while (other + otherLength < close && other[otherLength] != ','){
+					otherLength++;
+				}
+				if (other != choice && otherLength <= choiceLength && strncmp(other, choice, otherLength) == 0){
+					covered = otherLength < choiceLength || other < choice;
+				}
+				other += otherLength + 1;
+			}
+			if (!covered){
+				called += scan(address, search(node, choice, choiceLength, false), search(node, choice, choiceLength, true), segment, length, wild, end, msg);
+			}
+			choice += choiceLength + 1;
+		}
+	} else if (segment[0] == '[' && segment[1] != '!' && memchr(segment, ']', length) != NULL){
+		//the children whose first character is between the lowest and highest in the class
+		int low, high;
+		classRange(segment, &low, &high);
+		if (low <= high){
+			char lowest = low;
+			char highest = high;
+			called += scan(address, search(node, &lowest, 1, false), search(node, &highest, 1, true), segment, length, wild, end, msg);
+		}
+	} else {
+		called += scan(address, first, last, segment, length, wild, end, msg);
+	}
+	//the children registered with wildcards or captures could match anything
+	called += scan(address, last, last + nodes[node].patternCount, segment, length, wild, end, msg);
+	return called;
+}
+
+//so fired() only reports the handlers called from now on
+void OSCRouter::nextPass(){
+	if (++pass == 0){
+		for (int i = 0; i < numHandlers; i++){
+			handlers[i].pass = 0;
+		}
+		pass = 1;
+	}
+}
+
+//so find() only lists the handlers it reaches from now on
+void OSCRouter::nextLookup(){
+	if (++lookup == 0){
+		for (int i = 0; i < numHandlers; i++){
+			handlers[i].lookup = 0;
+		}
+		lookup = 1;
+	}
+}
+
+int OSCRouter::dispatch(OSCMessage & msg, int offset){
+	//a dispatch from inside a callback adds to the outer one's fired handlers
+	if (depth == 0){
+		nextPass();
+	}
+	if (numNodes == 0 || msg.address == NULL || (!sortedValid && !sortChildren())){
+		return 0;
+	}
+	//a dispatch from inside a callback numbers its captures from 0 again
+	int outerBase = captureBase;
+	captureBase = numCaptures;
+	depth++;
+	int called = walk(msg.address, 0, offset, &msg);
+	depth--;
+	captureBase = outerBase;
+	return called;
+}
+
+int OSCRouter::dispatch(OSCBundle & bundle, int offset){
+	if (depth == 0){
+		nextPass();
+	}
+	if (numNodes == 0 || (!sortedValid && !sortChildren())){
+		return 0;
+	}
+	int outerBase = captureBase;
+	captureBase = numCaptures;
+	depth++;
+	int called = 0;
+	for (int i = 0; i < bundle.size(); i++){
+		OSCMessage * msg = bundle.getOSCMessage(i);
+		if (msg->address != NULL){
+			called += walk(msg->address, 0, offset, msg);
+		}
+	}
+	depth--;
+	captureBase = outerBase;
+	return called;
+}
+
+int OSCRouter::find(const char * address, int * _found, int _foundSize){
+	nextLookup();
+	found = _found;
+	foundSize = _found != NULL ? _foundSize : 0;
+	numFound = 0;
+	if (numNodes > 0 && (sortedValid || sortChildren())){
+		walk(address, 0, 0, NULL);
+	}
+	found = NULL;
+	foundSize = 0;
+	return numFound;
+}
+
+bool OSCRouter::fired(int handler){
+	return pass != 0 && handler >= 0 && handler < numHandlers && handlers[handler].pass == pass;
+}
+
+/*=============================================================================
+	SIZE / ERRORS
+=============================================================================*/
+
+int OSCRouter::size(){
+	return numHandlers;
+}
+
+bool OSCRouter::hasError(){
+	return error != OSC_OK;
+}
+
+OSCErrorCode OSCRouter::getError(){
+	return error;
+}
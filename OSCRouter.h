@@ -0,0 +1,253 @@
+/*
+ The Center for New Music and Audio Technologies,
+ University of California, Berkeley.  Copyright (c) 2014, The Regents of
+ the University of California (Regents).
+ 
+ Permission to use, copy, modify, distribute, and distribute modified versions
+ of this software and its documentation without fee and without a signed
+ licensing agreement, is hereby granted, provided that the above copyright
+ notice, this paragraph and the following two paragraphs appear in all copies,
+ modifications, and distributions.
+ 
+ IN NO EVENT SHALL REGENTS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS, ARISING
+ OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF REGENTS HAS
+ BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE. THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED
+ HEREUNDER IS PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE
+ MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+#ifndef OSCROUTER_h
+#define OSCROUTER_h
+
+#include "OSCBundle.h"
+#include <stddef.h>
+
+//the most "%i" segments in one address
+#ifndef OSC_ROUTER_MAX_CAPTURES
+#define OSC_ROUTER_MAX_CAPTURES 4
+#endif
+
+//the nodes and handlers are defined in OSCRouter.cpp
+struct OSCRouteNode;
+struct OSCRouteHandler;
+
+/*
+ calls handlers registered against addresses
+
+ the addresses are split on '/' and merged into a tree with one node per
+ segment, so a message is dispatched by walking its address once instead
+ of matching it against every registered address in turn.
+
+ a segment of the incoming address which has wildcards in it is matched
+ with osc_match, so a pattern like "/led/?" reaches every handler below
+ "/led". the children of each node are kept sorted: a segment like
+ "{3,5,7}" or "1[0-2]" is turned into the names it stands for and each is
+ looked up, otherwise only the children which start with the segment's
+ first characters are tried. the cost follows the number of matches more
+ than the size of the namespace.
+
+ a "%i" segment in a registered address matches any whole number, and
+ the numbers are passed to the callback: "/d/%i" handles "/d/13" without
+ registering every pin. an incoming "/d/{3,5}" reaches it twice, but
+ a '*' or '?' can't stand for a number so "/d/" followed by '*' doesn't.
+ */
+
+class OSCRouter
+{
+
+private:
+
+/*=============================================================================
+	PRIVATE VARIABLES
+=============================================================================*/
+
+	OSCRouteNode * nodes;
+	int numNodes;
+	int nodesSize;
+
+	OSCRouteHandler * handlers;
+	int numHandlers;
+	int handlersSize;
+
+	//the segment names, one after another, each one NUL terminated
+	char * names;
+	int namesLength;
+
+	//each node's children, sorted by name, filled in by the first dispatch after adding
+	int * sorted;
+	bool sortedValid;
+
+	//the numbers matched by "%i" on the way down the tree
+	int captures[OSC_ROUTER_MAX_CAPTURES];
+	int numCaptures;
+	//where the current dispatch's captures start
+	int captureBase;
+
+	//where find() puts the handlers
+	int * found;
+	int foundSize;
+	int numFound;
+
+	//counts the outermost calls to dispatch, handlers remember the last one they fired in
+	unsigned int pass;
+	//counts the calls to find, handlers remember the last one they were found by
+	unsigned int lookup;
+	//how many dispatches are running, only the outermost one starts a new pass
+	int depth;
+
+	OSCErrorCode error;
+
+	//adds a node for the segment, returns its number or -1
+	int makeNode(const char * segment, int length);
+	//returns the child of the node with that name, adding it if there isn't one
+	int child(int node, const char * segment, int length);
+	//adds a handler at the end of the address, the caller sets its callback
+	int add(const char * address, uint8_t kind);
+	//sorts each node's children, returns false if there wasn't memory
+	bool sortChildren();
+	//binary search for the prefix in the node's sorted children
+	int search(int node, const char * prefix, int length, bool after);
+	//matches the segment of the address which starts at offset against the node's children
+	//msg is NULL when it's called by find
+	int walk(const char * address, int node, int offset, OSCMessage * msg);
+	//looks up each name the segment stands for
+	int expand(const char * address, int node, const char * segment, int length, int at, char * name, int nameLength, int end, OSCMessage * msg);
+	//walks the children in that part of the sorted list which match the segment
+	int scan(const char * address, int from, int to, const char * segment, int length, bool wild, int end, OSCMessage * msg);
+	//calls the handlers at the node
+	int fire(const char * address, int node, int offset, OSCMessage * msg);
+	//starts counting the handlers called by a new dispatch
+	void nextPass();
+	//starts listing the handlers reached by a new find
+	void nextLookup();
+
+	//fills in a T from the message and calls the callback with it, false if the type tags didn't match
+	typedef bool (*BindCall)(OSCMessage & msg, const char * types, void (*callback)(), const int * captures);
+	//adds a handler which decodes into a struct of that size and alignment, -1 if they don't fit the type tags
+	int addBinding(const char * address, const char * types, int size, int alignment, BindCall call, void (*callback)());
+
+	//where the compiler puts a T after a char, which is T's alignment
+	template <typename T>
+	struct Alignment {
+		char c;
+		T t;
+	};
+
+	//the struct is filled in byte by byte, so it has to be plain data
+	template <typename T>
+	static void checkBindable(){
+#if __cplusplus >= 201103L
+		static_assert(__is_standard_layout(T) && __is_trivially_copyable(T), "the struct an address is bound to has to be plain data");
+#endif
+	}
+
+	template <typename T>
+	static bool bindCall(OSCMessage & msg, const char * types, void (*callback)(), const int *){
+		T target;
+		if (!msg.getArguments(types, &target)){
+			return false;
+		}
+		((void (*)(T &)) callback)(target);
+		return true;
+	}
+
+	template <typename T>
+	static bool bindCallCaptures(OSCMessage & msg, const char * types, void (*callback)(), const int * captures){
+		T target;
+		if (!msg.getArguments(types, &target)){
+			return false;
+		}
+		((void (*)(T &, const int *)) callback)(target, captures);
+		return true;
+	}
+
+	//not copyable
+	OSCRouter(const OSCRouter &);
+	OSCRouter & operator=(const OSCRouter &);
+
+public:
+
+/*=============================================================================
+	CONSTRUCTORS / DESTRUCTOR
+=============================================================================*/
+
+	OSCRouter();
+
+	~OSCRouter();
+
+	//removes all of the handlers
+	void empty();
+
+/*=============================================================================
+	REGISTERING
+
+	the address is copied, each returns the handler's number or -1 on failure
+=============================================================================*/
+
+	//the callback is called with messages whose address fully matches
+	int addDispatch(const char * address, void (*callback)(OSCMessage &));
+
+	//the callback is called with messages whose address starts with this one
+	//it's passed the offset just after the matched part, like OSCMessage::route
+	int addRoute(const char * address, void (*callback)(OSCMessage &, int));
+
+	//the same, but the callbacks are also passed the numbers matched by "%i"
+	//segments, in the order they're in the address
+	int addDispatch(const char * address, void (*callback)(OSCMessage &, const int * captures));
+	int addRoute(const char * address, void (*callback)(OSCMessage &, int, const int * captures));
+
+	//the callback is passed a struct filled in from the arguments of messages whose address fully
+	//matches and whose type tags are exactly these, one field for each (see oscDecodeStruct)
+	//messages with other type tags are passed over, and don't count as calling the handler
+	//returns -1 if T's size or alignment doesn't match the type tags. the types and order of the
+	//fields themselves can't be checked, so they have to be declared in the order of the tags
+	template <typename T>
+	int addDispatch(const char * address, const char * types, void (*callback)(T &)){
+		checkBindable<T>();
+		return addBinding(address, types, sizeof(T), offsetof(Alignment<T>, t), &OSCRouter::bindCall<T>, (void (*)()) callback);
+	}
+	template <typename T>
+	int addDispatch(const char * address, const char * types, void (*callback)(T &, const int * captures)){
+		checkBindable<T>();
+		return addBinding(address, types, sizeof(T), offsetof(Alignment<T>, t), &OSCRouter::bindCallCaptures<T>, (void (*)()) callback);
+	}
+
+/*=============================================================================
+	DISPATCHING
+
+	returns the number of handlers which were called
+	a handler's callbacks happen in the order of the address, so a route on
+	"/a" is called before a dispatch on "/a/b"
+=============================================================================*/
+
+	//matches the address from the offset on, for routing from inside a route callback
+	int dispatch(OSCMessage & msg, int offset = 0);
+
+	//dispatches each message in the bundle
+	int dispatch(OSCBundle & bundle, int offset = 0);
+
+	//true if the handler was called by the last dispatch, or by a dispatch from inside its callbacks
+	bool fired(int handler);
+
+	//the handlers a message with the address (or pattern) would call, without calling them
+	//puts up to foundSize of their numbers in found and returns how many there are, each handler is listed once
+	int find(const char * address, int * found, int foundSize);
+
+/*=============================================================================
+	SIZE / ERRORS
+=============================================================================*/
+
+	//the number of handlers
+	int size();
+
+	bool hasError();
+
+	OSCErrorCode getError();
+};
+
+#endif
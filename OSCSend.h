@@ -0,0 +1,177 @@
+/*
+ The Center for New Music and Audio Technologies,
+ University of California, Berkeley.  Copyright (c) 2014, The Regents of
+ the University of California (Regents).
+ 
+ Permission to use, copy, modify, distribute, and distribute modified versions
+ of this software and its documentation without fee and without a signed
+ licensing agreement, is hereby granted, provided that the above copyright
+ notice, this paragraph and the following two paragraphs appear in all copies,
+ modifications, and distributions.
+ 
+ IN NO EVENT SHALL REGENTS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS, ARISING
+ OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF REGENTS HAS
+ BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE. THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED
+ HEREUNDER IS PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE
+ MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+
+#ifndef OSCSEND_h
+#define OSCSEND_h
+
+#include "OSCMessage.h"
+
+//the type tags are worked out from the argument types, which needs C++11
+#if __cplusplus >= 201103L
+
+/*
+ encodes a message straight from its arguments, without an OSCMessage
+
+	oscSend(Udp, "/motor", 3, 1.5f, "fast");
+
+ the type tags come from the C++ types of the arguments: integers up to
+ 32 bits are 'i', wider ones 'h' ('t' when unsigned, like OSCMessage::add(uint64_t)),
+ char is 'c', float is 'f', double is 'd' ('f' where a double has 4 bytes),
+ strings are 's' and a bool is 'T' or 'F'. other types don't compile.
+
+ nothing is allocated: the bytes go straight into the buffer, or are staged
+ on the stack on their way to the Print like OSCMessage::send.
+ */
+
+//how each type of argument is encoded
+template <typename T>
+struct OSCArgument {
+	static_assert(sizeof(T) == 0, "oscSend can't encode arguments of this type");
+};
+
+//a number with a fixed size, sent big-endian
+template <char Tag, typename Wire>
+struct OSCFixedArgument {
+	static constexpr char tag(Wire){ return Tag; }
+	static constexpr int size(Wire){ return sizeof(Wire); }
+	static void write(OSCEncoder & encoder, Wire value){
+		value = BigEndian(value);
+		encoder.write((const uint8_t *) &value, sizeof(value));
+	}
+};
+
+//integers are 'i' if they fit in 32 bits
+template <typename T, bool Wide = (sizeof(T) > 4)>
+struct OSCSignedArgument : OSCFixedArgument<'i', int32_t> {};
+template <typename T>
+struct OSCSignedArgument<T, true> : OSCFixedArgument<'h', int64_t> {};
+
+template <typename T, bool Wide = (sizeof(T) > 4)>
+struct OSCUnsignedArgument : OSCFixedArgument<'i', int32_t> {};
+template <typename T>
+struct OSCUnsignedArgument<T, true> : OSCFixedArgument<'t', uint64_t> {};
+
+template <> struct OSCArgument<signed char> : OSCSignedArgument<signed char> {};
+template <> struct OSCArgument<short> : OSCSignedArgument<short> {};
+template <> struct OSCArgument<int> : OSCSignedArgument<int> {};
+template <> struct OSCArgument<long> : OSCSignedArgument<long> {};
+template <> struct OSCArgument<long long> : OSCSignedArgument<long long> {};
+template <> struct OSCArgument<unsigned char> : OSCUnsignedArgument<unsigned char> {};
+template <> struct OSCArgument<unsigned short> : OSCUnsignedArgument<unsigned short> {};
+template <> struct OSCArgument<unsigned int> : OSCUnsignedArgument<unsigned int> {};
+template <> struct OSCArgument<unsigned long> : OSCUnsignedArgument<unsigned long> {};
+template <> struct OSCArgument<unsigned long long> : OSCUnsignedArgument<unsigned long long> {};
+
+template <> struct OSCArgument<char> : OSCFixedArgument<'c', int32_t> {};
+template <> struct OSCArgument<float> : OSCFixedArgument<'f', float> {};
+
+//some 8-bit boards only have a 4-byte double, which is really a float
+template <bool Eight = (sizeof(double) == 8)>
+struct OSCDoubleArgument : OSCFixedArgument<'d', double> {};
+template <>
+struct OSCDoubleArgument<false> : OSCFixedArgument<'f', float> {};
+
+template <> struct OSCArgument<double> : OSCDoubleArgument<> {};
+
+//the type tag is the value
+template <>
+struct OSCArgument<bool> {
+	static constexpr char tag(bool value){ return value ? 'T' : 'F'; }
+	static constexpr int size(bool){ return 0; }
+	static void write(OSCEncoder &, bool){}
+};
+
+template <>
+struct OSCArgument<const char *> {
+	static constexpr char tag(const char *){ return 's'; }
+	static int size(const char * str){
+		int strSize = strlen(str) + 1;
+		return strSize + padSize(strSize);
+	}
+	static void write(OSCEncoder & encoder, const char * str){
+		int strSize = strlen(str) + 1;
+		encoder.write((const uint8_t *) str, strSize);
+		encoder.pad(padSize(strSize));
+	}
+};
+
+template <> struct OSCArgument<char *> : OSCArgument<const char *> {};
+
+//the type tags, including the comma and the null, padded to 4 bytes
+template <typename... Args>
+struct OSCTypeTagsSize {
+	static constexpr int value = (sizeof...(Args) + 2 + 3) / 4 * 4;
+};
+
+//the number of bytes the message will take up
+template <typename... Args>
+size_t oscEncodedSize(const char * address, Args... args){
+	int addrLen = strlen(address) + 1;
+	size_t total = addrLen + padSize(addrLen) + OSCTypeTagsSize<Args...>::value;
+	//only the strings aren't known when compiling
+	int sizes[] = {0, OSCArgument<Args>::size(args)...};
+	for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++){
+		total += sizes[i];
+	}
+	return total;
+}
+
+//writes the message to the encoder, the arguments in order
+template <typename... Args>
+void oscEncode(OSCEncoder & encoder, const char * address, Args... args){
+	int addrLen = strlen(address) + 1;
+	encoder.write((const uint8_t *) address, addrLen);
+	encoder.pad(padSize(addrLen));
+	//the rest of the array is the null and the padding
+	char types[OSCTypeTagsSize<Args...>::value] = {',', OSCArgument<Args>::tag(args)...};
+	encoder.write((const uint8_t *) types, sizeof(types));
+	//the initializers are evaluated in order
+	int written[] = {0, (OSCArgument<Args>::write(encoder, args), 0)...};
+	(void) written;
+}
+
+//encodes the message into the buffer if it fits
+//returns the number of bytes it needs either way, like OSCMessage::encode
+template <typename... Args>
+size_t oscEncode(uint8_t * buffer, size_t capacity, const char * address, Args... args){
+	size_t messageSize = oscEncodedSize(address, args...);
+	if (messageSize <= capacity){
+		OSCEncoder encoder(buffer, capacity);
+		oscEncode(encoder, address, args...);
+	}
+	return messageSize;
+}
+
+//sends the message, with a single write when it fits in OSC_SEND_BUFFER_SIZE
+template <typename... Args>
+void oscSend(Print & p, const char * address, Args... args){
+	uint8_t buffer[OSC_SEND_BUFFER_SIZE];
+	OSCEncoder encoder(p, buffer, OSC_SEND_BUFFER_SIZE);
+	oscEncode(encoder, address, args...);
+	encoder.flush();
+}
+
+#endif
+
+#endif
@@ -0,0 +1,137 @@
+/*
+ The Center for New Music and Audio Technologies,
+ University of California, Berkeley.  Copyright (c) 2014, The Regents of
+ the University of California (Regents).
+ 
+ Permission to use, copy, modify, distribute, and distribute modified versions
+ of this software and its documentation without fee and without a signed
+ licensing agreement, is hereby granted, provided that the above copyright
+ notice, this paragraph and the following two paragraphs appear in all copies,
+ modifications, and distributions.
+ 
+ IN NO EVENT SHALL REGENTS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS, ARISING
+ OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF REGENTS HAS
+ BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE. THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED
+ HEREUNDER IS PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE
+ MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+
+#include "OSCStaticRouter.h"
+#include "OSCMatch.h"
+#include <string.h>
+
+#if __cplusplus >= 201103L
+
+/*=============================================================================
+	READING THE TABLES
+=============================================================================*/
+
+#if defined(__AVR__)
+static uint8_t readByte(const uint8_t * p){
+	return pgm_read_byte(p);
+}
+static uint16_t readWord(const uint16_t * p){
+	return pgm_read_word(p);
+}
+static void (*readCallback(void (* const * p)(OSCMessage &)))(OSCMessage &){
+	return (void (*)(OSCMessage &)) pgm_read_word(p);
+}
+static int compare(const char * address, const char * stored){
+	return strcmp_P(address, stored);
+}
+//osc_match needs the address in RAM
+static const char * addressIn(char * buffer, const char * stored){
+	strcpy_P(buffer, stored);
+	return buffer;
+}
+#else
+static uint8_t readByte(const uint8_t * p){
+	return *p;
+}
+static uint16_t readWord(const uint16_t * p){
+	return *p;
+}
+static void (*readCallback(void (* const * p)(OSCMessage &)))(OSCMessage &){
+	return *p;
+}
+static int compare(const char * address, const char * stored){
+	return strcmp(address, stored);
+}
+static const char * addressIn(char *, const char * stored){
+	return stored;
+}
+#endif
+
+static bool hasWildcards(const char * s){
+	return strpbrk(s, "*?[{") != NULL;
+}
+
+/*=============================================================================
+	DISPATCHING
+=============================================================================*/
+
+int OSCStaticRouterBase::lookup(const Tables & t, const char * address, uint32_t h){
+	int bucket = h & (t.numBuckets - 1);
+	uint16_t start = readWord(t.bucketStarts + bucket);
+	uint16_t size = readWord(t.bucketStarts + bucket + 1) - start;
+	if (size == 0){
+		return -1;
+	}
+	uint8_t seed = readByte(t.bucketSeeds + bucket);
+	int slot = start + place(mix(h, seed), size);
+	uint8_t route = readByte(t.slots + slot);
+	if (route == NO_ROUTE || compare(address, t.addresses + readWord(t.addressStarts + route)) != 0){
+		return -1;
+	}
+	return route;
+}
+
+int OSCStaticRouterBase::find(const Tables & t, const char * address){
+	return lookup(t, address, OSCAddressTable::hash(address));
+}
+
+int OSCStaticRouterBase::dispatch(const Tables & t, OSCMessage & msg, int offset){
+	if (msg.address == NULL){
+		return 0;
+	}
+	const char * address = msg.address + offset;
+	if (!hasWildcards(address)){
+		//a decoded message may already know its hash
+		uint32_t h = offset == 0 ? msg.getAddressHash() : OSCAddressTable::hash(address);
+		int route = lookup(t, address, h);
+		if (route < 0){
+			return 0;
+		}
+		readCallback(t.callbacks + route)(msg);
+		return 1;
+	}
+	//a pattern is matched against each address
+	char buffer[OSC_STATIC_ROUTER_MAX_ADDRESS + 1];
+	int called = 0;
+	for (int route = 0; route < t.count; route++){
+		const char * routeAddress = addressIn(buffer, t.addresses + readWord(t.addressStarts + route));
+		int patternOffset;
+		int addressOffset;
+		if (osc_match(address, routeAddress, &patternOffset, &addressOffset) == 3){
+			readCallback(t.callbacks + route)(msg);
+			called++;
+		}
+	}
+	return called;
+}
+
+int OSCStaticRouterBase::dispatch(const Tables & t, OSCBundle & bundle, int offset){
+	int called = 0;
+	for (int i = 0; i < bundle.size(); i++){
+		called += dispatch(t, *bundle.getOSCMessage(i), offset);
+	}
+	return called;
+}
+
+#endif
@@ -0,0 +1,429 @@
+/*
+ The Center for New Music and Audio Technologies,
+ University of California, Berkeley.  Copyright (c) 2014, The Regents of
+ the University of California (Regents).
+ 
+ Permission to use, copy, modify, distribute, and distribute modified versions
+ of this software and its documentation without fee and without a signed
+ licensing agreement, is hereby granted, provided that the above copyright
+ notice, this paragraph and the following two paragraphs appear in all copies,
+ modifications, and distributions.
+ 
+ IN NO EVENT SHALL REGENTS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS, ARISING
+ OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF REGENTS HAS
+ BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE. THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED
+ HEREUNDER IS PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE
+ MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+#ifndef OSCSTATICROUTER_h
+#define OSCSTATICROUTER_h
+
+#include "OSCBundle.h"
+
+//the table is worked out by the compiler, which needs C++11
+#if __cplusplus >= 201103L
+
+//the tables are kept in flash where that's separate from RAM
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define OSC_STATIC_PROGMEM PROGMEM
+#else
+#define OSC_STATIC_PROGMEM
+#endif
+
+//the longest address, a message with wildcards is matched against a copy on the stack
+#ifndef OSC_STATIC_ROUTER_MAX_ADDRESS
+#define OSC_STATIC_ROUTER_MAX_ADDRESS 64
+#endif
+
+struct OSCStaticRoute {
+	//a literal address, without wildcards
+	const char * address;
+	void (*callback)(OSCMessage &);
+};
+
+/*
+ calls handlers for a set of addresses which is known when compiling
+
+ the addresses are given as a constexpr array:
+
+	constexpr OSCStaticRoute routes[] = {
+		{"/led", led},
+		{"/tone/freq", toneFreq},
+	};
+	OSCStaticRouter<routes, sizeof(routes) / sizeof(routes[0])> router;
+
+ the compiler turns it into a perfect hash: the addresses are hashed into
+ buckets, and each bucket gets a seed which spreads its addresses over
+ slots of their own. a message is dispatched with one hash of its address
+ and one compare, and the tables (the slots, the addresses and the
+ callbacks) are constant data, in flash on AVR, so the routes take no RAM.
+
+ only a message whose address has wildcards in it is matched against each
+ route in turn with osc_match.
+ */
+
+//the part which doesn't depend on the routes
+class OSCStaticRouterBase
+{
+
+protected:
+
+	//where the template's tables are, handed to dispatch
+	struct Tables {
+		//every address, one after another, NUL terminated
+		const char * addresses;
+		//where each route's address starts
+		const uint16_t * addressStarts;
+		void (* const * callbacks)(OSCMessage &);
+		int count;
+		//where each bucket's slots start, one more than there are buckets
+		const uint16_t * bucketStarts;
+		const uint8_t * bucketSeeds;
+		//a power of two
+		int numBuckets;
+		//the route in each slot, NO_ROUTE if there isn't one
+		const uint8_t * slots;
+	};
+
+	enum { NO_ROUTE = 255 };
+
+	//the same as OSCAddressTable::hash
+	static constexpr uint32_t hash(const char * address, uint32_t h = 2166136261UL){
+		return *address == '\0' ? h : hash(address + 1, (h ^ (uint8_t) *address) * 16777619UL);
+	}
+
+	//the hash within a bucket, for that seed
+	static constexpr uint32_t mix(uint32_t h, uint32_t seed){
+		return mixBits((h ^ (seed * 0x9E3779B9UL)) * 0x85EBCA6BUL);
+	}
+	static constexpr uint32_t mixBits(uint32_t x){
+		return (x ^ (x >> 13)) * 0xC2B2AE35UL;
+	}
+
+	//maps the mixed hash onto a bucket of that size
+	static constexpr int place(uint32_t mixed, uint32_t size){
+		return (int) (((mixed >> 16) * size) >> 16);
+	}
+
+	static constexpr int length(const char * address){
+		return *address == '\0' ? 0 : 1 + length(address + 1);
+	}
+
+	static constexpr int powerOfTwo(int n, int p = 1){
+		return p >= n ? p : powerOfTwo(n, p * 2);
+	}
+
+	//each half is only worked out once when it's passed in
+	static constexpr int larger(int a, int b){
+		return a > b ? a : b;
+	}
+
+	//the route with the address, found from its hash, or -1
+	static int lookup(const Tables &, const char * address, uint32_t hash);
+	static int find(const Tables &, const char * address);
+
+	//return the number of handlers which were called
+	static int dispatch(const Tables &, OSCMessage & msg, int offset);
+	static int dispatch(const Tables &, OSCBundle & bundle, int offset);
+
+/*=============================================================================
+	WORKED OUT WHEN COMPILING
+
+	the compiler doesn't remember what a constexpr function returned, so
+	the plan is made in steps which each fill a table of their own, and a
+	step only reads the tables before it. each table costs about as much
+	as a loop over the routes, instead of the work multiplying out
+=============================================================================*/
+
+	//for expanding the tables
+	template <int...> struct Indices {};
+	template <typename, typename> struct Join;
+	template <int... a, int... b> struct Join<Indices<a...>, Indices<b...> > {
+		typedef Indices<a..., sizeof...(a) + b...> type;
+	};
+	//0 to n - 1, made from halves so big tables don't nest too deeply
+	template <int n> struct Count {
+		typedef typename Join<typename Count<n / 2>::type, typename Count<n - n / 2>::type>::type type;
+	};
+
+	//Step::at(i) for each of the indices, worked out once
+	template <typename Step, typename T, typename> struct Table;
+	template <typename Step, typename T, int... i> struct Table<Step, T, Indices<i...> > {
+		static constexpr T values[sizeof...(i)] = { Step::at(i)... };
+	};
+
+	//the sum of the table's values in [from, to)
+	template <typename Values>
+	static constexpr int sum(int from, int to){
+		return to <= from ? 0 : to - from == 1 ? (int) Values::values[from]
+			: sum<Values>(from, (from + to) / 2) + sum<Values>((from + to) / 2, to);
+	}
+
+	//the largest of the table's values in [from, to)
+	template <typename Values>
+	static constexpr int largest(int from, int to){
+		return to - from <= 1 ? (int) Values::values[from]
+			: larger(largest<Values>(from, (from + to) / 2), largest<Values>((from + to) / 2, to));
+	}
+
+	//the last index in [from, to) whose value is at most n, for a table which only goes up
+	template <typename Values>
+	static constexpr int lastAtMost(int n, int from, int to){
+		return to - from <= 1 ? from
+			: (int) Values::values[(from + to) / 2] <= n ? lastAtMost<Values>(n, (from + to) / 2, to)
+			: lastAtMost<Values>(n, from, (from + to) / 2);
+	}
+
+	template <const OSCStaticRoute * routes, int count> struct Plan;
+};
+
+template <> struct OSCStaticRouterBase::Count<0> { typedef Indices<> type; };
+template <> struct OSCStaticRouterBase::Count<1> { typedef Indices<0> type; };
+
+template <typename Step, typename T, int... i>
+constexpr T OSCStaticRouterBase::Table<Step, T, OSCStaticRouterBase::Indices<i...> >::values[sizeof...(i)];
+
+template <const OSCStaticRoute * routes, int count>
+struct OSCStaticRouterBase::Plan
+{
+	//about one address per bucket
+	enum { numBuckets = powerOfTwo(count) };
+
+	struct Hash {
+		static constexpr uint32_t at(int route){ return hash(routes[route].address); }
+	};
+	typedef Table<Hash, uint32_t, typename Count<count>::type> Hashes;
+
+	static constexpr int bucketOf(int route){
+		return (int) (Hashes::values[route] & (numBuckets - 1));
+	}
+
+	//the number of routes in [from, to) in the bucket
+	static constexpr int countIn(int bucket, int from, int to){
+		return to <= from ? 0 : to - from == 1 ? (bucketOf(from) == bucket ? 1 : 0)
+			: countIn(bucket, from, (from + to) / 2) + countIn(bucket, (from + to) / 2, to);
+	}
+
+	struct BucketCount {
+		static constexpr int at(int bucket){ return countIn(bucket, 0, count); }
+	};
+	typedef Table<BucketCount, int, typename Count<numBuckets>::type> BucketCounts;
+
+	//where each bucket's routes start when they're put in order of bucket
+	struct BucketFirst {
+		static constexpr int at(int bucket){ return sum<BucketCounts>(0, bucket); }
+	};
+	typedef Table<BucketFirst, int, typename Count<numBuckets + 1>::type> BucketFirsts;
+
+	struct Position {
+		static constexpr int at(int route){ return BucketFirsts::values[bucketOf(route)] + countIn(bucketOf(route), 0, route); }
+	};
+	typedef Table<Position, int, typename Count<count>::type> Positions;
+
+	//the route at the position, or -1 for none in [from, to)
+	static constexpr int routeAt(int position, int from, int to){
+		return to - from == 1 ? (Positions::values[from] == position ? from : -1)
+			: larger(routeAt(position, from, (from + to) / 2), routeAt(position, (from + to) / 2, to));
+	}
+
+	//the routes in order of bucket
+	struct Member {
+		static constexpr int at(int position){ return routeAt(position, 0, count); }
+	};
+	typedef Table<Member, int, typename Count<count>::type> Members;
+
+	//a bucket with n addresses has n * n slots, so a seed which gives each
+	//one a slot of its own is found in a couple of tries
+	struct BucketSize {
+		static constexpr int at(int bucket){ return BucketCounts::values[bucket] * BucketCounts::values[bucket]; }
+	};
+	typedef Table<BucketSize, int, typename Count<numBuckets>::type> BucketSizes;
+
+	struct BucketStart {
+		static constexpr int at(int bucket){ return sum<BucketSizes>(0, bucket); }
+	};
+	typedef Table<BucketStart, int, typename Count<numBuckets + 1>::type> BucketStarts;
+
+	//the route's slot in its bucket with that seed
+	static constexpr int placeOf(int route, int seed){
+		return place(mix(Hashes::values[route], seed), BucketSizes::values[bucketOf(route)]);
+	}
+
+	//whether the route at the position lands in the same slot as one in [other, end)
+	static constexpr bool clashes(int position, int other, int end, int seed){
+		return other < end && (placeOf(Members::values[position], seed) == placeOf(Members::values[other], seed)
+			|| clashes(position, other + 1, end, seed));
+	}
+
+	//whether the seed gives the routes in [position, end) slots of their own
+	static constexpr bool spreads(int position, int end, int seed){
+		return position >= end || (!clashes(position, position + 1, end, seed) && spreads(position + 1, end, seed));
+	}
+
+	static constexpr int seedFrom(int bucket, int seed){
+		return seed == NO_ROUTE || spreads(BucketFirsts::values[bucket], BucketFirsts::values[bucket + 1], seed)
+			? seed : seedFrom(bucket, seed + 1);
+	}
+
+	//NO_ROUTE if there isn't one
+	struct Seed {
+		static constexpr int at(int bucket){ return seedFrom(bucket, 0); }
+	};
+	typedef Table<Seed, int, typename Count<numBuckets>::type> Seeds;
+
+	//whether each bucket in [from, to) has a seed
+	static constexpr bool seeded(int from, int to){
+		return to <= from ? true : to - from == 1 ? Seeds::values[from] != NO_ROUTE
+			: seeded(from, (from + to) / 2) && seeded((from + to) / 2, to);
+	}
+
+	//the route from [position, end) whose place in the bucket is that one
+	static constexpr int routeIn(int place, int position, int end, int seed){
+		return position >= end ? (int) NO_ROUTE
+			: placeOf(Members::values[position], seed) == place ? Members::values[position]
+			: routeIn(place, position + 1, end, seed);
+	}
+
+	//the route in each slot
+	struct Slot {
+		static constexpr int at(int slot){ return slotIn(slot, lastAtMost<BucketStarts>(slot, 0, numBuckets)); }
+		static constexpr int slotIn(int slot, int bucket){
+			return routeIn(slot - BucketStarts::values[bucket], BucketFirsts::values[bucket],
+				BucketFirsts::values[bucket + 1], Seeds::values[bucket]);
+		}
+	};
+
+	static constexpr int numSlots(){
+		return BucketStarts::values[numBuckets];
+	}
+
+	//the characters of each address, with its NUL
+	struct Length {
+		static constexpr int at(int route){ return length(routes[route].address) + 1; }
+	};
+	typedef Table<Length, int, typename Count<count>::type> Lengths;
+
+	//where each address starts in the table of addresses
+	struct AddressStart {
+		static constexpr int at(int route){ return sum<Lengths>(0, route); }
+	};
+	typedef Table<AddressStart, int, typename Count<count>::type> AddressStarts;
+
+	static constexpr int numChars(){
+		return sum<Lengths>(0, count);
+	}
+
+	static constexpr int longest(){
+		return largest<Lengths>(0, count) - 1;
+	}
+
+	//each character of the table of addresses
+	struct Char {
+		static constexpr char at(int i){ return charIn(i, lastAtMost<AddressStarts>(i, 0, count)); }
+		static constexpr char charIn(int i, int route){
+			return routes[route].address[i - AddressStarts::values[route]];
+		}
+	};
+};
+
+template <const OSCStaticRoute * routes, int count>
+class OSCStaticRouter : public OSCStaticRouterBase
+{
+
+private:
+
+	typedef Plan<routes, count> plan;
+
+	static_assert(count > 0 && count < NO_ROUTE, "OSCStaticRouter takes between 1 and 254 routes");
+	static_assert(plan::longest() <= OSC_STATIC_ROUTER_MAX_ADDRESS, "an address is longer than OSC_STATIC_ROUTER_MAX_ADDRESS");
+	static_assert(plan::numChars() < 65536 && plan::numSlots() < 65536, "OSCStaticRouter's addresses are too long");
+	static_assert(plan::seeded(0, plan::numBuckets), "OSCStaticRouter couldn't find a perfect hash, two of the addresses may be the same");
+
+/*=============================================================================
+	THE TABLES
+=============================================================================*/
+
+	template <int... i>
+	static const char * addresses(Indices<i...>){
+		static const char table[] OSC_STATIC_PROGMEM = { plan::Char::at(i)... };
+		return table;
+	}
+
+	template <int... i>
+	static const uint16_t * addressStarts(Indices<i...>){
+		static const uint16_t table[] OSC_STATIC_PROGMEM = { (uint16_t) plan::AddressStarts::values[i]... };
+		return table;
+	}
+
+	template <int... i>
+	static void (* const * callbacks(Indices<i...>))(OSCMessage &){
+		static void (* const table[])(OSCMessage &) OSC_STATIC_PROGMEM = { routes[i].callback... };
+		return table;
+	}
+
+	template <int... i>
+	static const uint16_t * bucketStarts(Indices<i...>){
+		static const uint16_t table[] OSC_STATIC_PROGMEM = { (uint16_t) plan::BucketStarts::values[i]... };
+		return table;
+	}
+
+	template <int... i>
+	static const uint8_t * bucketSeeds(Indices<i...>){
+		static const uint8_t table[] OSC_STATIC_PROGMEM = { (uint8_t) plan::Seeds::values[i]... };
+		return table;
+	}
+
+	template <int... i>
+	static const uint8_t * slots(Indices<i...>){
+		static const uint8_t table[] OSC_STATIC_PROGMEM = { (uint8_t) plan::Slot::at(i)... };
+		return table;
+	}
+
+	static Tables tables(){
+		Tables t;
+		t.addresses = addresses(typename Count<plan::numChars()>::type());
+		t.addressStarts = addressStarts(typename Count<count>::type());
+		t.callbacks = callbacks(typename Count<count>::type());
+		t.count = count;
+		t.bucketStarts = bucketStarts(typename Count<plan::numBuckets + 1>::type());
+		t.bucketSeeds = bucketSeeds(typename Count<plan::numBuckets>::type());
+		t.numBuckets = plan::numBuckets;
+		t.slots = slots(typename Count<plan::numSlots()>::type());
+		return t;
+	}
+
+public:
+
+	//the route with exactly that address, or -1
+	static int find(const char * address){
+		return OSCStaticRouterBase::find(tables(), address);
+	}
+
+	//calls the handler for the message's address, or each one it matches if it has wildcards
+	//matches the address from the offset on, for routing from inside a route callback
+	//returns the number of handlers which were called
+	static int dispatch(OSCMessage & msg, int offset = 0){
+		return OSCStaticRouterBase::dispatch(tables(), msg, offset);
+	}
+
+	//dispatches each message in the bundle
+	static int dispatch(OSCBundle & bundle, int offset = 0){
+		return OSCStaticRouterBase::dispatch(tables(), bundle, offset);
+	}
+
+	//the number of routes
+	static int size(){
+		return count;
+	}
+};
+
+#endif
+
+#endif
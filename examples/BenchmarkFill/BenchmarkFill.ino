@@ -0,0 +1,69 @@
+/*
+    Compares decoding a received message one byte at a time
+    with handing the whole packet to fill() in one go,
+    for messages with 1, 16 and 128 float arguments.
+
+    Open the Serial Monitor to see the results.
+ */
+#include <OSCMessage.h>
+
+//enough for the 128 argument message
+uint8_t packet[680];
+
+const int iterations = 200;
+
+void benchmark(int argumentCount){
+    //make the packet
+    OSCMessage msg("/bench/frame");
+    for (int i = 0; i < argumentCount; i++){
+        msg.add((float) i);
+    }
+    int length = msg.encode(packet, sizeof(packet));
+    if (length > sizeof(packet)){
+        Serial.println("packet buffer is too small");
+        return;
+    }
+
+    //one byte at a time, the way a stream is decoded
+    unsigned long start = micros();
+    for (int n = 0; n < iterations; n++){
+        OSCMessage msgIN;
+        for (int i = 0; i < length; i++){
+            msgIN.fill(packet[i]);
+        }
+    }
+    unsigned long bytewise = micros() - start;
+
+    //the whole packet at once, the way a UDP datagram is decoded
+    start = micros();
+    for (int n = 0; n < iterations; n++){
+        OSCMessage msgIN;
+        msgIN.fill(packet, length);
+    }
+    unsigned long whole = micros() - start;
+
+    Serial.print(argumentCount);
+    Serial.print(" arguments, ");
+    Serial.print(length);
+    Serial.print(" bytes: byte-wise ");
+    Serial.print((float) bytewise / iterations);
+    Serial.print(" us, packet ");
+    Serial.print((float) whole / iterations);
+    Serial.println(" us");
+}
+
+void setup() {
+    Serial.begin(9600);
+#if ARDUINO >= 100
+    while(!Serial)
+      ;   // Leonardo bug
+#endif
+}
+
+void loop(){
+    benchmark(1);
+    benchmark(16);
+    benchmark(128);
+    Serial.println();
+    delay(5000);
+}
@@ -0,0 +1,71 @@
+/*
+    Times osc_match on the patterns which are the hardest for it:
+    a segment with many stars, like "*a*a*a*b", against a long run
+    of a's which never ends in a b.
+
+    The time should grow in step with the length of the address,
+    not blow up with the number of stars.
+
+    Open the Serial Monitor to see the results.
+ */
+#include <OSCMatch.h>
+
+//enough for the longest address and pattern
+char address[260];
+char pattern[40];
+
+const int iterations = 20;
+
+void benchmark(int stars, int length){
+    //"/*a*a...*b"
+    int p = 0;
+    pattern[p++] = '/';
+    for (int i = 0; i < stars; i++){
+        pattern[p++] = '*';
+        pattern[p++] = 'a';
+    }
+    pattern[p++] = '*';
+    pattern[p++] = 'b';
+    pattern[p] = '\0';
+
+    //"/aaa...a"
+    address[0] = '/';
+    for (int i = 1; i <= length; i++){
+        address[i] = 'a';
+    }
+    address[length + 1] = '\0';
+
+    int patternOffset, addressOffset;
+    int matched = 0;
+    unsigned long start = micros();
+    for (int n = 0; n < iterations; n++){
+        matched += osc_match(pattern, address, &patternOffset, &addressOffset) == 3;
+    }
+    unsigned long elapsed = micros() - start;
+
+    Serial.print(stars);
+    Serial.print(" stars, ");
+    Serial.print(length);
+    Serial.print(" characters: ");
+    Serial.print((float) elapsed / iterations);
+    Serial.print(" us");
+    Serial.println(matched ? " (matched?!)" : "");
+}
+
+void setup() {
+    Serial.begin(9600);
+#if ARDUINO >= 100
+    while(!Serial)
+      ;   // Leonardo bug
+#endif
+}
+
+void loop(){
+    for (int stars = 2; stars <= 16; stars *= 2){
+        for (int length = 16; length <= 256; length *= 4){
+            benchmark(stars, length);
+        }
+    }
+    Serial.println();
+    delay(5000);
+}
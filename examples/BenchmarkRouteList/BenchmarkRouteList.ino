@@ -0,0 +1,91 @@
+/*
+    Times an OSCRouteList on a recorded mix of traffic: a TouchOSC
+    layout with 24 controls, where the faders being moved are the
+    last ones in the list and the buttons on the first page are
+    hardly ever touched.
+
+    Each ordering is timed with and without early exit. With early
+    exit the busy addresses should end up at the front and cost a
+    few compares instead of a walk down the list.
+
+    Open the Serial Monitor to see the results.
+ */
+#include <OSCMessage.h>
+#include <OSCRouteList.h>
+
+const int numControls = 24;
+
+const char * addresses[numControls] = {
+    "/1/push1", "/1/push2", "/1/push3", "/1/push4",
+    "/1/toggle1", "/1/toggle2", "/1/toggle3", "/1/toggle4",
+    "/2/xy1", "/2/xy2", "/2/rotary1", "/2/rotary2",
+    "/2/rotary3", "/2/rotary4", "/3/multipush1", "/3/multipush2",
+    "/3/led1", "/3/led2", "/4/fader1", "/4/fader2",
+    "/4/fader3", "/4/fader4", "/4/fader5", "/4/fader6"
+};
+
+//the controls touched in the recording and how many messages each one sent, in order
+const uint8_t recording[][2] = {
+    {23, 40}, {22, 35}, {21, 12}, {0, 1}, {23, 25}, {20, 18}, {9, 30},
+    {8, 12}, {23, 20}, {19, 10}, {4, 1}, {22, 22}, {18, 8}, {12, 5},
+    {23, 30}, {21, 9}, {1, 1}, {9, 15}, {22, 16}, {23, 12}
+};
+const int recordingLength = sizeof(recording) / sizeof(recording[0]);
+
+int handled;
+
+void handle(OSCMessage &msg){
+    handled++;
+}
+
+OSCRouteList list(numControls);
+
+void benchmark(const char * name, OSCRouteList::Ordering ordering, bool stopOnMatch){
+    list.empty();
+    for (int i = 0; i < numControls; i++){
+        list.addDispatch(addresses[i], handle);
+    }
+    list.setOrdering(ordering);
+    list.setStopOnMatch(stopOnMatch);
+
+    OSCMessage msg;
+    unsigned long elapsed = 0;
+    long messages = 0;
+    handled = 0;
+    for (int i = 0; i < recordingLength; i++){
+        msg.setAddress(addresses[recording[i][0]]);
+        //timed a run at a time, micros() is too coarse for one message
+        unsigned long start = micros();
+        for (int n = 0; n < recording[i][1]; n++){
+            list.dispatch(msg);
+        }
+        elapsed += micros() - start;
+        messages += recording[i][1];
+    }
+
+    Serial.print(name);
+    Serial.print(stopOnMatch ? ", early exit: " : ": ");
+    Serial.print((float) elapsed / messages);
+    Serial.print(" us, ");
+    Serial.print((float) elapsed * clockCyclesPerMicrosecond() / messages);
+    Serial.print(" cycles per message");
+    Serial.println(handled == messages ? "" : " (missed some?!)");
+}
+
+void setup() {
+    Serial.begin(9600);
+#if ARDUINO >= 100
+    while(!Serial)
+      ;   // Leonardo bug
+#endif
+}
+
+void loop(){
+    for (int stop = 0; stop <= 1; stop++){
+        benchmark("fixed", OSCRouteList::ORDER_FIXED, stop);
+        benchmark("move to front", OSCRouteList::ORDER_MOVE_TO_FRONT, stop);
+        benchmark("by count", OSCRouteList::ORDER_BY_COUNT, stop);
+    }
+    Serial.println();
+    delay(5000);
+}
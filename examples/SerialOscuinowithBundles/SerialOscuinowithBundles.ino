@@ -351,6 +351,9 @@ void setup() {
       ;   // Leonardo bug
 #endif
 
+    //keep the outgoing messages from one loop to the next instead of reallocating them
+    bundleOUT.reserve(NUM_DIGITAL_PINS + NUM_ANALOG_INPUTS, 1);
+
 }
 
 //reads and routes the incoming messages
@@ -0,0 +1,72 @@
+/*
+* Set the LED from "/led" messages, and add up the bytes of "/file" blobs,
+* without building the messages
+*
+* the parser is told about each part of the packet as it arrives,
+* so a blob of any size goes by in small pieces
+*/
+#include <OSCParser.h>
+#include <OSCBoards.h>
+
+#ifdef BOARD_HAS_USB_SERIAL
+#include <SLIPEncodedUSBSerial.h>
+SLIPEncodedUSBSerial SLIPSerial( thisBoardsSerialUSB );
+#else
+#include <SLIPEncodedSerial.h>
+ SLIPEncodedSerial SLIPSerial(Serial);
+#endif
+
+class Receiver : public OSCParser {
+  bool led;
+  bool file;
+
+public:
+  unsigned long checksum;
+
+  void messageBegin(const char * address, const char * types){
+    led = strcmp(address, "/led") == 0;
+    file = strcmp(address, "/file") == 0;
+  }
+
+  //"/led ,i"
+  void argument(int position, char type){
+    if (led && type == 'i'){
+      pinMode(LED_BUILTIN, OUTPUT);
+      digitalWrite(LED_BUILTIN, getInt() > 0 ? HIGH : LOW);
+    }
+  }
+
+  //"/file ,b", however long it is
+  void argumentData(int position, char type, const uint8_t * bytes, int length, bool last){
+    if (file && type == 'b'){
+      for (int i = 0; i < length; i++)
+        checksum += bytes[i];
+    }
+  }
+};
+
+Receiver receiver;
+
+void setup() {
+    SLIPSerial.begin(9600);   // set this as high as you can reliably run on your platform
+#if ARDUINO >= 100
+    while(!Serial)
+      ;   // Leonardo bug
+#endif
+
+}
+
+//hands the bytes to the parser as they arrive
+void loop(){ 
+  int size;
+
+  while(!SLIPSerial.endofPacket())
+    if( (size =SLIPSerial.available()) > 0)
+    {
+       while(size--)
+          receiver.fill(SLIPSerial.read());
+     }
+
+  //ready for the next packet, false if this one was broken
+  receiver.endPacket();
+}
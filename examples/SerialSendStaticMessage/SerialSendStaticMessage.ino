@@ -0,0 +1,39 @@
+#include <OSCMessage.h>
+
+/*
+Send an OSC message over serial without using the heap
+
+The message is a global with room for 1 argument, a 16 character
+address and 4 bytes of data. Nothing is allocated while the sketch runs.
+ */
+
+#ifdef BOARD_HAS_USB_SERIAL
+#include <SLIPEncodedUSBSerial.h>
+SLIPEncodedUSBSerial SLIPSerial( thisBoardsSerialUSB );
+#else
+#include <SLIPEncodedSerial.h>
+ SLIPEncodedSerial SLIPSerial(Serial);
+#endif
+
+StaticOSCMessage<1, 16, 4> msg("/analog/0");
+
+void setup() {
+  //begin SLIPSerial just like Serial
+  SLIPSerial.begin(9600);   // set this as high as you can reliably run on your platform
+#if ARDUINO >= 100
+  while(!Serial)
+    ; //Leonardo "feature"
+#endif
+}
+
+
+void loop(){
+  msg.add((int32_t)analogRead(0));
+
+  SLIPSerial.beginPacket();  
+    msg.send(SLIPSerial); // send the bytes to the SLIP stream
+  SLIPSerial.endPacket(); // mark the end of the OSC Packet
+  msg.empty(); // keeps the address, the storage is reused for the next reading
+
+  delay(20);
+}
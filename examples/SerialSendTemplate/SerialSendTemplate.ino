@@ -0,0 +1,42 @@
+#include <OSCMessageTemplate.h>
+
+/*
+Send the analog inputs over serial as fast as possible
+
+Each input has an OSCMessageTemplate which encoded its address and
+type tags once, in setup. The loop only writes the new reading into
+the frame, which is then sent as it is.
+ */
+
+#ifdef BOARD_HAS_USB_SERIAL
+#include <SLIPEncodedUSBSerial.h>
+SLIPEncodedUSBSerial SLIPSerial( thisBoardsSerialUSB );
+#else
+#include <SLIPEncodedSerial.h>
+ SLIPEncodedSerial SLIPSerial(Serial);
+#endif
+
+OSCMessageTemplate a0("/a/0", "i");
+OSCMessageTemplate a1("/a/1", "i");
+OSCMessageTemplate a2("/a/2", "i");
+OSCMessageTemplate a3("/a/3", "i");
+OSCMessageTemplate * analogs[] = { &a0, &a1, &a2, &a3 };
+
+void setup() {
+  //begin SLIPSerial just like Serial
+  SLIPSerial.begin(115200);   // set this as high as you can reliably run on your platform
+#if ARDUINO >= 100
+  while(!Serial)
+    ; //Leonardo "feature"
+#endif
+}
+
+void loop(){
+  for(int i = 0; i < 4; i++){
+    analogs[i]->set(0, analogRead(i));
+
+    SLIPSerial.beginPacket();
+      analogs[i]->send(SLIPSerial); // one write of the whole frame
+    SLIPSerial.endPacket();
+  }
+}
@@ -394,6 +394,9 @@ void setup() {
   Ethernet.begin(mac,ip);
   Udp.begin(inPort);
 
+  //keep the outgoing messages from one loop to the next instead of reallocating them
+  bundleOUT.reserve(NUM_DIGITAL_PINS + NUM_ANALOG_INPUTS, 1);
+
 }
 
 //reads and routes the incoming messages
@@ -0,0 +1,89 @@
+
+#include <Ethernet.h>
+#include <EthernetUdp.h>
+#include <SPI.h>    
+
+#include <OSCBundle.h>
+#include <OSCRouter.h>
+
+/*
+* UDPRouter
+* Registers the addresses once with an OSCRouter, which then
+* dispatches each incoming bundle by walking the addresses once
+*/
+
+EthernetUDP Udp;
+byte mac[] = {  
+  0xDE, 0xAD, 0xBE, 0xEF, 0xFE, 0xED }; // you can find this written on the board of some Arduino Ethernets or shields
+
+//the Arduino's IP
+IPAddress ip(128, 32, 122, 252);
+
+//port numbers
+const unsigned int inPort = 8888;
+
+OSCRouter router;
+OSCRouter pinRouter;
+int ledHandler;
+//when the led was last set
+unsigned long ledTime;
+
+//"/led" takes one int, on or off
+void led(OSCMessage &msg){
+  digitalWrite(13, msg.getInt(0) > 0 ? HIGH : LOW);
+}
+
+//"/pin/mode/...", the rest of the address is routed on from the offset
+void routePinMode(OSCMessage &msg, int addrOffset){
+  pinRouter.dispatch(msg, addrOffset);
+}
+
+//"/pin/mode/output/13", the pin number is taken from the address
+void pinOutput(OSCMessage &msg, const int * captures){
+  pinMode(captures[0], OUTPUT);
+}
+
+void pinInput(OSCMessage &msg, const int * captures){
+  pinMode(captures[0], INPUT);
+}
+
+//"/pwm/9 ,if" is decoded straight into the struct, one field per type tag
+struct Fade {
+  int32_t level;
+  float seconds;
+};
+
+void pwm(Fade &fade, const int * captures){
+  analogWrite(captures[0], fade.level);
+}
+
+void setup() {
+  //setup ethernet part
+  Ethernet.begin(mac,ip);
+  Udp.begin(inPort);
+
+  ledHandler = router.addDispatch("/led", led);
+  router.addRoute("/pin/mode", routePinMode);
+  pinRouter.addDispatch("/output/%i", pinOutput);
+  pinRouter.addDispatch("/input/%i", pinInput);
+  //messages with other type tags don't reach it
+  router.addDispatch("/pwm/%i", "if", pwm);
+}
+
+//reads and dispatches the incoming bundle
+void loop(){ 
+  OSCBundle bundleIN;
+  int size;
+
+  if( (size = Udp.parsePacket())>0)
+  {
+    while(size--)
+      bundleIN.fill(Udp.read());
+
+    if(!bundleIN.hasError()){
+      router.dispatch(bundleIN);
+      if(router.fired(ledHandler))
+        ledTime = millis();
+    }
+  }
+}
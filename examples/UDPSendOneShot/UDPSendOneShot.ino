@@ -0,0 +1,36 @@
+/*
+    Send an OSC message over UDP without making an OSCMessage
+
+    oscSend works out the type tags from the arguments
+    and encodes them straight into the packet, nothing is allocated
+ */
+#include <Ethernet.h>
+#include <EthernetUdp.h>
+#include <SPI.h>    
+#include <OSCSend.h>
+
+EthernetUDP Udp;
+
+//the Arduino's IP
+IPAddress ip(128, 32, 122, 252);
+//destination IP
+IPAddress outIp(128, 32, 122, 125);
+const unsigned int outPort = 9999;
+
+ byte mac[] = {  
+  0xDE, 0xAD, 0xBE, 0xEF, 0xFE, 0xED }; // you can find this written on the board of some Arduino Ethernets or shields
+void setup() {
+  Ethernet.begin(mac,ip);
+    Udp.begin(8888);
+
+}
+
+
+void loop(){
+  Udp.beginPacket(outIp, outPort);
+    //",iis": two ints and a string
+    oscSend(Udp, "/analog", analogRead(0), analogRead(1), "volts");
+  Udp.endPacket(); // mark the end of the OSC Packet
+
+  delay(20);
+}
@@ -0,0 +1,69 @@
+#include <Ethernet.h>
+#include <EthernetUdp.h>
+#include <SPI.h>    
+
+#include <OSCBundle.h>
+#include <OSCStaticRouter.h>
+
+/*
+* UDPStaticRouter
+* The addresses are fixed, so the compiler builds the routing
+* table: it's kept in flash and each literal address is found
+* with one hash and one compare
+*/
+
+EthernetUDP Udp;
+byte mac[] = {  
+  0xDE, 0xAD, 0xBE, 0xEF, 0xFE, 0xED }; // you can find this written on the board of some Arduino Ethernets or shields
+
+//the Arduino's IP
+IPAddress ip(128, 32, 122, 252);
+
+//port numbers
+const unsigned int inPort = 8888;
+
+//"/led" takes one int, on or off
+void led(OSCMessage &msg){
+  digitalWrite(13, msg.getInt(0) > 0 ? HIGH : LOW);
+}
+
+//"/tone/freq" takes the frequency in Hz
+void toneFreq(OSCMessage &msg){
+  tone(8, msg.getInt(0));
+}
+
+void toneOff(OSCMessage &msg){
+  noTone(8);
+}
+
+//"/tone/*" reaches both of the tone handlers
+constexpr OSCStaticRoute routes[] = {
+  {"/led", led},
+  {"/tone/freq", toneFreq},
+  {"/tone/off", toneOff},
+};
+
+OSCStaticRouter<routes, sizeof(routes) / sizeof(routes[0])> router;
+
+void setup() {
+  //setup ethernet part
+  Ethernet.begin(mac,ip);
+  Udp.begin(inPort);
+
+  pinMode(13, OUTPUT);
+}
+
+//reads and dispatches the incoming bundle
+void loop(){ 
+  OSCBundle bundleIN;
+  int size;
+
+  if( (size = Udp.parsePacket())>0)
+  {
+    while(size--)
+      bundleIN.fill(Udp.read());
+
+    if(!bundleIN.hasError())
+      router.dispatch(bundleIN);
+  }
+}